@@ -176,6 +176,23 @@ void AActor::AddInventory(AInventory *item)
 	}
 }
 
+// Swaps in the position frac of the way from the start of the tic for drawing.
+void AActor::BeginInterpolation(fixed frac)
+{
+	tickx = x;
+	ticky = y;
+	tickz = z;
+	tickangle = angle;
+
+	if(!HasPrevState())
+		return;
+
+	x = prevx + FixedMul(x - prevx, frac);
+	y = prevy + FixedMul(y - prevy, frac);
+	z = prevz + FixedMul(z - prevz, frac);
+	angle = prevangle + FixedMul(static_cast<fixed>(angle - prevangle), frac);
+}
+
 // This checks if this can see the specified actor. It replaces FL_VISABLE checks.
 bool AActor::CheckVisibility(const AActor *check, angle_t fov) const
 {
@@ -314,6 +331,14 @@ void AActor::Die()
 		Destroy();
 }
 
+void AActor::EndInterpolation()
+{
+	x = tickx;
+	y = ticky;
+	z = tickz;
+	angle = tickangle;
+}
+
 void AActor::EnterZone(const MapZone *zone)
 {
 	if(zone)
@@ -579,6 +604,11 @@ bool AActor::Teleport(fixed x, fixed y, angle_t angle, bool nofog)
 	this->y = y;
 	this->angle = angle;
 
+	// Don't interpolate across the map
+	prevx = x;
+	prevy = y;
+	prevangle = angle;
+
 	EnterZone(destination->zone);
 
 	if(!nofog)
@@ -754,6 +784,14 @@ int32_t AActor::SpawnHealth() const
 	return GetClass()->Meta.GetMetaInt(AMETA_DefaultHealth1 + gamestate.difficulty->SpawnFilter, health);
 }
 
+void AActor::StorePrevState()
+{
+	prevx = x;
+	prevy = y;
+	prevz = z;
+	prevangle = angle;
+}
+
 DEFINE_SYMBOL(Actor, angle)
 DEFINE_SYMBOL(Actor, health)
 
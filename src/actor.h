@@ -96,12 +96,14 @@ class AActor : public Thinker,
 		typedef LinkedList<DropItem> DropList;
 
 		void			AddInventory(AInventory *item);
+		void			BeginInterpolation(fixed frac);
 		virtual void	BeginPlay() {}
 		void			ClearCounters();
 		void			ClearInventory();
 		bool			CheckVisibility(const AActor *check, angle_t fov=ANGLE_45) const;
 		virtual void	Destroy();
 		virtual void	Die();
+		void			EndInterpolation();
 		void			EnterZone(const MapZone *zone);
 		AInventory		*FindInventory(const ClassDef *cls);
 		const Frame		*FindState(const FName &name) const;
@@ -123,6 +125,7 @@ class AActor : public Thinker,
 		void			SpawnFog();
 		static AActor	*Spawn(const ClassDef *type, fixed x, fixed y, fixed z, int flags);
 		int32_t			SpawnHealth() const;
+		void			StorePrevState();
 		bool			Teleport(fixed x, fixed y, angle_t angle, bool nofog=false);
 		virtual void	Tick();
 		virtual void	Touch(AActor *toucher) {}
@@ -201,6 +204,13 @@ class AActor : public Thinker,
 		short       temp1,hidden;
 		fixed		killerx,killery; // For deathcam
 
+		// For uncapped rendering: position at the start of the tic, and the
+		// simulated position while an interpolated one is being drawn.
+		fixed		prevx, prevy, prevz;
+		angle_t		prevangle;
+		fixed		tickx, ticky, tickz;
+		angle_t		tickangle;
+
 		TObjPtr<AActor> target;
 		player_t	*player;	// Only valid with APlayerPawn
 
@@ -43,6 +43,9 @@
 #include "wl_agent.h"
 #include "wl_main.h"
 #include "wl_play.h"
+#include "wl_pacer.h"
+#include "wl_rewind.h"
+#include "textures/textures.h"
 
 static bool doWriteConfig = false;
 
@@ -50,11 +53,12 @@ Aspect r_ratio = ASPECT_4_3, vid_aspect = ASPECT_NONE;
 bool forcegrabmouse = false;
 bool vid_fullscreen = false;
 bool vid_vsync = true;
+bool vid_uncapped = false;
 bool quitonescape = false;
 fixed movebob = FRACUNIT;
 
 bool alwaysrun;
-bool mouseenabled, mouseyaxisdisabled, joystickenabled;
+bool mouseenabled, mouseyaxisdisabled, joystickenabled, latemouselatch;
 float localDesiredFOV = 90.0f;
 
 #if SDL_VERSION_ATLEAST(1,3,0)
@@ -152,6 +156,7 @@ void FinalReadConfig()
 	SD_SetSoundMode(sd);
 	SD_SetDigiDevice(sds);
 	N3DTempoEmulation = !!config.GetSetting("N3DTempoEmulation")->GetInteger();
+	MusicPrerenderMemory = config.GetSetting("MusicPrerenderMemory")->GetInteger();
 
 	AM_UpdateFlags();
 
@@ -183,14 +188,19 @@ void ReadConfig(void)
 	config.CreateSetting("MusicDevice", smm_AdLib);
 	config.CreateSetting("DigitalSoundDevice", sds_SoundBlaster);
 	config.CreateSetting("N3DTempoEmulation", false);
+	config.CreateSetting("MusicPrerenderMemory", MusicPrerenderMemory);
+	config.CreateSetting("DigitizedVoices", DigiMixer::NumVoices);
 	config.CreateSetting("AlwaysRun", 0);
 	config.CreateSetting("MouseYAxisDisabled", 0);
+	config.CreateSetting("LateMouseLatch", 1);
 	config.CreateSetting("SoundVolume", MAX_VOLUME);
 	config.CreateSetting("MusicVolume", MAX_VOLUME);
 	config.CreateSetting("DigitizedVolume", MAX_VOLUME);
 	config.CreateSetting("Vid_FullScreen", false);
 	config.CreateSetting("Vid_Aspect", ASPECT_NONE);
 	config.CreateSetting("Vid_Vsync", true);
+	config.CreateSetting("Vid_Uncapped", false);
+	config.CreateSetting("Vid_MaxFPS", Pacer::MaxFPS);
 	config.CreateSetting("FullScreenWidth", fullScreenWidth);
 	config.CreateSetting("FullScreenHeight", fullScreenHeight);
 	config.CreateSetting("WindowedScreenWidth", windowedScreenWidth);
@@ -206,6 +216,9 @@ void ReadConfig(void)
 	config.CreateSetting("AM_OverlayTextured", false);
 	config.CreateSetting("AM_Pause", true);
 	config.CreateSetting("AM_ShowRatios", false);
+	config.CreateSetting("RewindInterval", Rewind::Interval);
+	config.CreateSetting("RewindMemory", Rewind::MemoryLimit);
+	config.CreateSetting("TextureCacheMemory", TexMan.CacheLimit);
 
 	char joySettingName[50] = {0};
 	char keySettingName[50] = {0};
@@ -250,6 +263,7 @@ void ReadConfig(void)
 	panxadjustment = config.GetSetting("PanXAdjustment")->GetInteger();
 	panyadjustment = config.GetSetting("PanYAdjustment")->GetInteger();
 	mouseyaxisdisabled = config.GetSetting("MouseYAxisDisabled")->GetInteger() != 0;
+	latemouselatch = config.GetSetting("LateMouseLatch")->GetInteger() != 0;
 	alwaysrun = config.GetSetting("AlwaysRun")->GetInteger() != 0;
 	AdlibVolume = config.GetSetting("SoundVolume")->GetInteger();
 	MusicVolume = config.GetSetting("MusicVolume")->GetInteger();
@@ -257,6 +271,8 @@ void ReadConfig(void)
 	vid_fullscreen = 0; // default to windowed mode on start for web
 	vid_aspect = static_cast<Aspect>(config.GetSetting("Vid_Aspect")->GetInteger());
 	vid_vsync = config.GetSetting("Vid_Vsync")->GetInteger() != 0;
+	vid_uncapped = config.GetSetting("Vid_Uncapped")->GetInteger() != 0;
+	Pacer::MaxFPS = config.GetSetting("Vid_MaxFPS")->GetInteger();
 	fullScreenWidth = config.GetSetting("FullScreenWidth")->GetInteger();
 	fullScreenHeight = config.GetSetting("FullScreenHeight")->GetInteger();
 	windowedScreenWidth = config.GetSetting("WindowedScreenWidth")->GetInteger();
@@ -283,6 +299,10 @@ void ReadConfig(void)
 	am_overlaytextured = config.GetSetting("AM_OverlayTextured")->GetInteger() != 0;
 	am_pause = config.GetSetting("AM_Pause")->GetInteger() != 0;
 	am_showratios = config.GetSetting("AM_ShowRatios")->GetInteger() != 0;
+	Rewind::Interval = config.GetSetting("RewindInterval")->GetInteger();
+	Rewind::MemoryLimit = config.GetSetting("RewindMemory")->GetInteger();
+	DigiMixer::NumVoices = config.GetSetting("DigitizedVoices")->GetInteger();
+	TexMan.CacheLimit = config.GetSetting("TextureCacheMemory")->GetInteger();
 
 	char hsName[50];
 	char hsScore[50];
@@ -400,17 +420,22 @@ void WriteConfig(void)
 	config.GetSetting("PanXAdjustment")->SetValue(panxadjustment);
 	config.GetSetting("PanYAdjustment")->SetValue(panyadjustment);
 	config.GetSetting("MouseYAxisDisabled")->SetValue(mouseyaxisdisabled);
+	config.GetSetting("LateMouseLatch")->SetValue(latemouselatch);
 	config.GetSetting("AlwaysRun")->SetValue(alwaysrun);
 	config.GetSetting("SoundDevice")->SetValue(SoundMode);
 	config.GetSetting("MusicDevice")->SetValue(MusicMode);
 	config.GetSetting("DigitalSoundDevice")->SetValue(DigiMode);
 	config.GetSetting("N3DTempoEmulation")->SetValue(N3DTempoEmulation);
+	config.GetSetting("MusicPrerenderMemory")->SetValue(MusicPrerenderMemory);
+	config.GetSetting("DigitizedVoices")->SetValue(DigiMixer::NumVoices);
 	config.GetSetting("SoundVolume")->SetValue(AdlibVolume);
 	config.GetSetting("MusicVolume")->SetValue(MusicVolume);
 	config.GetSetting("DigitizedVolume")->SetValue(SoundVolume);
 	config.GetSetting("Vid_FullScreen")->SetValue(vid_fullscreen);
 	config.GetSetting("Vid_Aspect")->SetValue(vid_aspect);
 	config.GetSetting("Vid_Vsync")->SetValue(vid_vsync);
+	config.GetSetting("Vid_Uncapped")->SetValue(vid_uncapped);
+	config.GetSetting("Vid_MaxFPS")->SetValue(Pacer::MaxFPS);
 	config.GetSetting("FullScreenWidth")->SetValue(fullScreenWidth);
 	config.GetSetting("FullScreenHeight")->SetValue(fullScreenHeight);
 	config.GetSetting("WindowedScreenWidth")->SetValue(windowedScreenWidth);
@@ -426,6 +451,9 @@ void WriteConfig(void)
 	config.GetSetting("AM_OverlayTextured")->SetValue(am_overlaytextured);
 	config.GetSetting("AM_Pause")->SetValue(am_pause);
 	config.GetSetting("AM_ShowRatios")->SetValue(am_showratios);
+	config.GetSetting("RewindInterval")->SetValue(Rewind::Interval);
+	config.GetSetting("RewindMemory")->SetValue(Rewind::MemoryLimit);
+	config.GetSetting("TextureCacheMemory")->SetValue(TexMan.CacheLimit);
 
 	char hsName[50];
 	char hsScore[50];
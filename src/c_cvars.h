@@ -61,6 +61,7 @@ extern bool		r_depthfog;
 extern bool		vid_fullscreen;
 extern Aspect	vid_aspect;
 extern bool		vid_vsync;
+extern bool		vid_uncapped;
 extern bool		quitonescape;
 extern fixed	movebob;
 
@@ -69,6 +70,6 @@ extern float	localDesiredFOV;
 // control info
 //
 extern  bool		alwaysrun;
-extern  bool		mouseenabled, mouseyaxisdisabled, joystickenabled;
+extern  bool		mouseenabled, mouseyaxisdisabled, joystickenabled, latemouselatch;
 
 #endif /* __C_CVARS__ */
@@ -34,10 +34,18 @@
 ** It was, but the results were not as good as I would like, so I didn't
 ** actually use it. But I did keep the code around in case I ever felt like
 ** revisiting the problem. I never did, so now it's relegated to the mists
-** of SVN history, and this is just a thin wrapper around BestColor().
+** of SVN history.
+**
+** [ECWolf] This version gives the exact same results as BestColor(). The
+** color cube is split into 8x8x8 cells and for each cell the palette entries
+** which could possibly be the closest to some point inside of it are listed.
+** That is any entry whose nearest distance to the cell is no more than the
+** smallest farthest distance of all the entries. A pick then only needs to
+** check a handful of entries instead of all 254.
 **
 */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,6 +53,17 @@
 #include "colormatcher.h"
 #include "v_palette.h"
 
+// Same range BestColor() searches by default
+enum
+{
+	FIRST_COLOR = 1,
+	END_COLOR = 255,
+
+	CELL_SHIFT = 5,
+	CELL_SIZE = 1<<CELL_SHIFT,
+	CELLS = 256>>CELL_SHIFT
+};
+
 FColorMatcher::FColorMatcher ()
 {
 	Pal = NULL;
@@ -63,12 +82,55 @@ FColorMatcher::FColorMatcher (const FColorMatcher &other)
 FColorMatcher &FColorMatcher::operator= (const FColorMatcher &other)
 {
 	Pal = other.Pal;
+	Candidates = other.Candidates;
+	memcpy (CellStart, other.CellStart, sizeof(CellStart));
 	return *this;
 }
 
+// Squared distance from a channel value to the nearest and farthest points of
+// the cell spanning [lo, lo+CELL_SIZE-1].
+static inline int NearDist (int c, int lo)
+{
+	const int d = c < lo ? lo - c : (c > lo+CELL_SIZE-1 ? c - (lo+CELL_SIZE-1) : 0);
+	return d*d;
+}
+
+static inline int FarDist (int c, int lo)
+{
+	const int d = MAX(abs(c - lo), abs(c - (lo+CELL_SIZE-1)));
+	return d*d;
+}
+
 void FColorMatcher::SetPalette (const DWORD *palette)
 {
 	Pal = (const PalEntry *)palette;
+	Candidates.Clear();
+	if (Pal == NULL)
+		return;
+
+	int nearDist[END_COLOR];
+	for (int cell = 0; cell < CELLS*CELLS*CELLS; ++cell)
+	{
+		const int rlo = (cell / (CELLS*CELLS)) << CELL_SHIFT;
+		const int glo = ((cell / CELLS) % CELLS) << CELL_SHIFT;
+		const int blo = (cell % CELLS) << CELL_SHIFT;
+
+		int bound = INT_MAX;
+		for (int color = FIRST_COLOR; color < END_COLOR; ++color)
+		{
+			nearDist[color] = NearDist(Pal[color].r, rlo) + NearDist(Pal[color].g, glo) + NearDist(Pal[color].b, blo);
+			bound = MIN(bound, FarDist(Pal[color].r, rlo) + FarDist(Pal[color].g, glo) + FarDist(Pal[color].b, blo));
+		}
+
+		// Kept in index order so that ties go to the lowest index.
+		CellStart[cell] = Candidates.Size();
+		for (int color = FIRST_COLOR; color < END_COLOR; ++color)
+		{
+			if (nearDist[color] <= bound)
+				Candidates.Push(color);
+		}
+	}
+	CellStart[CELLS*CELLS*CELLS] = Candidates.Size();
 }
 
 BYTE FColorMatcher::Pick (int r, int g, int b)
@@ -76,5 +138,26 @@ BYTE FColorMatcher::Pick (int r, int g, int b)
 	if (Pal == NULL)
 		return 1;
 
-	return (BYTE)BestColor ((uint32 *)Pal, r, g, b);
+	if ((unsigned)(r|g|b) > 255)
+		return (BYTE)BestColor ((uint32 *)Pal, r, g, b);
+
+	const unsigned int cell = (((r >> CELL_SHIFT)*CELLS) + (g >> CELL_SHIFT))*CELLS + (b >> CELL_SHIFT);
+	const BYTE *color = &Candidates[CellStart[cell]];
+	const BYTE *const end = &Candidates[0] + CellStart[cell+1];
+
+	int bestcolor = *color;
+	int bestdist = INT_MAX;
+	for (; color < end; ++color)
+	{
+		const int x = r - Pal[*color].r;
+		const int y = g - Pal[*color].g;
+		const int z = b - Pal[*color].b;
+		const int dist = x*x + y*y + z*z;
+		if (dist < bestdist)
+		{
+			bestdist = dist;
+			bestcolor = *color;
+		}
+	}
+	return (BYTE)bestcolor;
 }
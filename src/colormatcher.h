@@ -34,6 +34,7 @@
 #ifndef __COLORMATCHER_H__
 #define __COLORMATCHER_H__
 
+#include "tarray.h"
 #include "v_palette.h"
 
 class FColorMatcher
@@ -54,6 +55,8 @@ public:
 
 private:
 	const PalEntry *Pal;
+	TArray<BYTE> Candidates;
+	unsigned int CellStart[8*8*8+1];
 };
 
 extern FColorMatcher ColorMatcher;
@@ -0,0 +1,142 @@
+// Large archives can be streamed instead of preloaded by listing them before
+// the module starts:
+//
+//   Module.lazyFiles = [{ path: "/data/mod.pk3", url: "data/mod.pk3" }];
+//
+// Each file is registered as an empty placeholder and read a block at a time
+// with HTTP range requests by FLazyFileReader (lazyfile.cpp). Fetched blocks
+// are kept in IndexedDB so later sessions only hit the network for data they
+// haven't seen yet. The blocks are thrown out if the ETag or size reported by
+// the server changes. The server must report Content-Length for HEAD requests
+// and should honor Range (tools/rangeserver.js does both for local testing).
+// Keep placeholders out of the IDBFS mounted settings directory.
+
+Module["preRun"] = Module["preRun"] || [];
+
+// Must match LAZY_BLOCK_SIZE in lazyfile.cpp
+const LAZY_BLOCK_SIZE = 65536;
+// Longer runs of missing blocks are split into requests of this many blocks
+// which are made at the same time.
+const LAZY_REQUEST_BLOCKS = 16;
+
+const lazyFiles = new Map();
+let lazyCache = null;
+
+const resolveLazyPath = (path) => {
+	try {
+		return FS.lookupPath(path).path;
+	} catch (e) {
+		return path;
+	}
+};
+
+const openLazyCache = () => new Promise((resolve) => {
+	if (typeof indexedDB === "undefined") return resolve(null);
+
+	const req = indexedDB.open("ecwolf-lazyfiles", 2);
+	req.onupgradeneeded = () => {
+		for (const store of ["blocks", "versions"]) {
+			if (!req.result.objectStoreNames.contains(store)) req.result.createObjectStore(store);
+		}
+	};
+	req.onsuccess = () => resolve(req.result);
+	req.onerror = () => resolve(null);
+});
+
+const lazyCacheRequest = (store, mode, action) => new Promise((resolve) => {
+	if (!lazyCache) return resolve(undefined);
+
+	const req = action(lazyCache.transaction(store, mode).objectStore(store));
+	req.onsuccess = () => resolve(req.result);
+	req.onerror = () => resolve(undefined);
+});
+
+const fetchLazyRange = async (file, start, end) => {
+	const response = await fetch(file.url, { headers: { Range: `bytes=${start}-${end - 1}` } });
+	if (!response.ok) throw new Error(`Could not fetch ${file.url}: ${response.status}`);
+
+	// Don't mix blocks from different versions of the file
+	const etag = response.headers.get("ETag");
+	if (file.etag && etag && etag !== file.etag) throw new Error(`${file.url} changed while it was in use`);
+
+	const data = new Uint8Array(await response.arrayBuffer());
+	// Servers without range support send the whole file
+	return response.status === 206 ? data : data.subarray(start, end);
+};
+
+Module["lazyFileSize"] = (path) => {
+	const file = lazyFiles.get(resolveLazyPath(path));
+	return file ? file.size : -1;
+};
+
+Module["lazyFileFetch"] = async (path, firstBlock, numBlocks) => {
+	const file = lazyFiles.get(resolveLazyPath(path));
+	const start = firstBlock * LAZY_BLOCK_SIZE;
+	const end = Math.min((firstBlock + numBlocks) * LAZY_BLOCK_SIZE, file.size);
+	const result = new Uint8Array(end - start);
+
+	// Fill what we can from the cache, then fetch the missing runs
+	const cached = await Promise.all(Array.from({ length: numBlocks }, (_, i) =>
+		lazyCacheRequest("blocks", "readonly", (store) => store.get(`${file.url}#${firstBlock + i}`))));
+
+	const missing = [];
+	for (let i = 0; i < numBlocks; ++i) {
+		const last = missing[missing.length - 1];
+		if (cached[i]) result.set(new Uint8Array(cached[i]), i * LAZY_BLOCK_SIZE);
+		else if (last && last.end === i && last.end - last.start < LAZY_REQUEST_BLOCKS) ++last.end;
+		else missing.push({ start: i, end: i + 1 });
+	}
+
+	await Promise.all(missing.map(async (run) => {
+		const runStart = start + run.start * LAZY_BLOCK_SIZE;
+		const runEnd = Math.min(start + run.end * LAZY_BLOCK_SIZE, end);
+		const data = await fetchLazyRange(file, runStart, runEnd);
+		result.set(data, runStart - start);
+
+		for (let i = run.start; i < run.end; ++i) {
+			const block = data.slice((i - run.start) * LAZY_BLOCK_SIZE, (i - run.start + 1) * LAZY_BLOCK_SIZE);
+			lazyCacheRequest("blocks", "readwrite", (store) => store.put(block.buffer, `${file.url}#${firstBlock + i}`));
+		}
+	}));
+	return result;
+};
+
+// Drops the cached blocks of a file if it isn't the version they came from.
+const validateLazyCache = async (file) => {
+	const version = `${file.etag || ""}/${file.size}`;
+	if (await lazyCacheRequest("versions", "readonly", (store) => store.get(file.url)) === version) return;
+
+	await lazyCacheRequest("blocks", "readwrite", (store) => store.delete(IDBKeyRange.bound(`${file.url}#`, `${file.url}#\uffff`)));
+	await lazyCacheRequest("versions", "readwrite", (store) => store.put(version, file.url));
+};
+
+const lazyFilesSetup = () => {
+	if (!Module["lazyFiles"] || !Module["lazyFiles"].length) return;
+
+	addRunDependency("lazyFiles");
+
+	(async () => {
+		lazyCache = await openLazyCache();
+
+		for (const { path, url } of Module["lazyFiles"]) {
+			try {
+				const response = await fetch(url, { method: "HEAD" });
+				const size = parseInt(response.headers.get("Content-Length"), 10);
+				if (!response.ok || isNaN(size)) throw new Error(`No size for ${url}`);
+
+				const file = { url, size, etag: response.headers.get("ETag") };
+				await validateLazyCache(file);
+
+				FS.mkdirTree(path.substring(0, path.lastIndexOf("/")) || "/");
+				FS.writeFile(path, new Uint8Array(0));
+				lazyFiles.set(resolveLazyPath(path), file);
+			} catch (err) {
+				console.error(`Could not register lazy file ${path}: `, err);
+			}
+		}
+
+		removeRunDependency("lazyFiles");
+	})();
+};
+
+Module["preRun"].push(lazyFilesSetup);
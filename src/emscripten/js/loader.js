@@ -0,0 +1,52 @@
+// Picks the best engine build the browser (or Node) can run and returns its
+// module factory. Used with custom frontends (EMSCRIPTEN_DEFAULT_FRONTEND off)
+// when both the plain and the SIMD/pthreads variant are deployed next to
+// this file:
+//
+//   import { loadEngine } from "./ecwolf-loader.mjs";
+//   const createModule = await loadEngine();
+//   const module = await createModule({ ... });
+//
+// To check which variant would be chosen without a browser:
+//
+//   node --input-type=module -e 'import("./ecwolf-loader.mjs").then(m => console.log(m.selectVariant()))'
+
+const BASE_NAME = "ecwolf";
+
+// (module (func (result v128) i32.const 0 i8x16.splat i8x16.popcnt))
+const SIMD_PROBE = new Uint8Array([
+	0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+	0x00, 0x01, 0x7b, 0x03, 0x02, 0x01, 0x00, 0x0a, 0x0a, 0x01, 0x08, 0x00,
+	0x41, 0x00, 0xfd, 0x0f, 0xfd, 0x62, 0x0b
+]);
+
+export const supportsSimd = () => {
+	try {
+		return WebAssembly.validate(SIMD_PROBE);
+	} catch (e) {
+		return false;
+	}
+};
+
+// Shared memory is only handed out to cross origin isolated pages. Node has
+// no such restriction and doesn't define crossOriginIsolated.
+export const supportsThreads = () =>
+	typeof SharedArrayBuffer !== "undefined" &&
+	typeof WebAssembly.Memory === "function" &&
+	globalThis.crossOriginIsolated !== false;
+
+export const selectVariant = () =>
+	supportsSimd() && supportsThreads() ? `${BASE_NAME}-simd-mt` : BASE_NAME;
+
+export const loadEngine = async (baseUrl = new URL(".", import.meta.url)) => {
+	const variant = selectVariant();
+	if (variant !== BASE_NAME) {
+		try {
+			return (await import(new URL(`${variant}.js`, baseUrl).href)).default;
+		} catch (err) {
+			// Variant wasn't deployed, fall back to the plain build
+			console.warn(`Could not load ${variant}, using ${BASE_NAME}: `, err);
+		}
+	}
+	return (await import(new URL(`${BASE_NAME}.js`, baseUrl).href)).default;
+};
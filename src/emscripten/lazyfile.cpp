@@ -0,0 +1,254 @@
+/*
+** lazyfile.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+**
+*/
+
+#include <emscripten.h>
+
+#include "wl_def.h"
+#include "doomerrors.h"
+#include "emscripten/lazyfile.h"
+
+// Must match js/lazyFiles.js
+#define LAZY_BLOCK_SIZE 65536
+
+// Blocks which aren't kept are freed least recently used first past this
+// many. They are still in the browser's cache so reading them again is cheap.
+#define MAX_LOOSE_BLOCKS 32
+#define BLOCK_KEPT 0xFFFFFFFFu
+
+// Preload fetches this many blocks per call so that only that much is held
+// twice while it's split into blocks.
+#define PRELOAD_BLOCKS 64
+
+EM_JS(double, ecwolf_lazy_size, (const char *path), {
+	return Module["lazyFileSize"](UTF8ToString(path));
+});
+
+EM_ASYNC_JS(int, ecwolf_lazy_fetch, (const char *path, int firstBlock, int numBlocks, void *dest), {
+	try {
+		const data = await Module["lazyFileFetch"](UTF8ToString(path), firstBlock, numBlocks);
+		HEAPU8.set(data, dest);
+		return 1;
+	} catch (err) {
+		console.error(err);
+		return 0;
+	}
+});
+
+FLazyFileReader *FLazyFileReader::Open(const char *filename)
+{
+	const double size = ecwolf_lazy_size(filename);
+	if(size < 0)
+		return NULL;
+	return new FLazyFileReader(filename, static_cast<long>(size));
+}
+
+FLazyFileReader::FLazyFileReader(const char *filename, long length)
+: FileReader(), Path(filename), UseCount(0), NumLoose(0), Keeping(false)
+{
+	Length = length;
+	Blocks.Resize((length + LAZY_BLOCK_SIZE - 1)/LAZY_BLOCK_SIZE);
+	LastUse.Resize(Blocks.Size());
+	for(unsigned int i = 0;i < Blocks.Size();++i)
+	{
+		Blocks[i] = NULL;
+		LastUse[i] = 0;
+	}
+}
+
+FLazyFileReader::~FLazyFileReader()
+{
+	for(unsigned int i = 0;i < Blocks.Size();++i)
+		delete[] Blocks[i];
+}
+
+long FLazyFileReader::Tell() const
+{
+	return FilePos;
+}
+
+long FLazyFileReader::Seek(long offset, int origin)
+{
+	if(origin == SEEK_CUR)
+		offset += FilePos;
+	else if(origin == SEEK_END)
+		offset += Length;
+
+	if(offset < 0 || offset > Length)
+		return -1;
+	FilePos = offset;
+	return 0;
+}
+
+void FLazyFileReader::Touch(unsigned int block)
+{
+	if(LastUse[block] == BLOCK_KEPT)
+		return;
+
+	if(Keeping)
+	{
+		LastUse[block] = BLOCK_KEPT;
+		--NumLoose;
+	}
+	else
+		LastUse[block] = ++UseCount;
+}
+
+// Frees the least recently used blocks outside of first through last until
+// no more than MAX_LOOSE_BLOCKS are loaded.
+void FLazyFileReader::TrimBlocks(unsigned int first, unsigned int last)
+{
+	while(NumLoose > MAX_LOOSE_BLOCKS)
+	{
+		int oldest = -1;
+		for(unsigned int i = 0;i < Blocks.Size();++i)
+		{
+			if(!Blocks[i] || LastUse[i] == BLOCK_KEPT || (i >= first && i <= last))
+				continue;
+			if(oldest < 0 || LastUse[i] < LastUse[oldest])
+				oldest = i;
+		}
+		if(oldest < 0)
+			break;
+
+		delete[] Blocks[oldest];
+		Blocks[oldest] = NULL;
+		--NumLoose;
+	}
+}
+
+bool FLazyFileReader::Prefetch(long start, long len)
+{
+	if(len <= 0)
+		return true;
+
+	const unsigned int first = start/LAZY_BLOCK_SIZE;
+	const unsigned int last = MIN<unsigned int>((start + len - 1)/LAZY_BLOCK_SIZE, Blocks.Size()-1);
+
+	// Fetch each run of missing blocks with a single request.
+	for(unsigned int block = first;block <= last;)
+	{
+		if(Blocks[block])
+		{
+			++block;
+			continue;
+		}
+
+		unsigned int end = block;
+		while(end < last && !Blocks[end+1])
+			++end;
+
+		const long runStart = static_cast<long>(block)*LAZY_BLOCK_SIZE;
+		const long runSize = MIN<long>(static_cast<long>(end+1)*LAZY_BLOCK_SIZE, Length) - runStart;
+		TArray<BYTE> data(runSize);
+		data.Resize(runSize);
+		if(!ecwolf_lazy_fetch(Path, block, end-block+1, &data[0]))
+			return false;
+
+		for(unsigned int i = block;i <= end;++i)
+		{
+			const long offset = static_cast<long>(i-block)*LAZY_BLOCK_SIZE;
+			const long size = MIN<long>(LAZY_BLOCK_SIZE, runSize - offset);
+			Blocks[i] = new BYTE[LAZY_BLOCK_SIZE];
+			memcpy(Blocks[i], &data[offset], size);
+			LastUse[i] = 0;
+			++NumLoose;
+			Touch(i);
+		}
+		block = end+1;
+	}
+
+	TrimBlocks(first, last);
+	return true;
+}
+
+bool FLazyFileReader::Preload()
+{
+	bool ok = true;
+	Keeping = true;
+	for(long start = 0;ok && start < Length;start += PRELOAD_BLOCKS*LAZY_BLOCK_SIZE)
+		ok = Prefetch(start, PRELOAD_BLOCKS*LAZY_BLOCK_SIZE);
+
+	// Keep what was already read before the preload as well
+	for(unsigned int i = 0;i < Blocks.Size();++i)
+	{
+		if(Blocks[i])
+			Touch(i);
+	}
+	Keeping = false;
+	return ok;
+}
+
+long FLazyFileReader::Read(void *buffer, long len)
+{
+	if(FilePos + len > Length)
+		len = Length - FilePos;
+	if(len <= 0)
+		return 0;
+
+	BYTE *out = static_cast<BYTE *>(buffer);
+	long remaining = len;
+	while(remaining > 0)
+	{
+		// Large reads are fetched a piece at a time so that they don't
+		// need to be held in memory all at once.
+		const unsigned int block = FilePos/LAZY_BLOCK_SIZE;
+		if(!Blocks[block] && !Prefetch(FilePos, MIN<long>(remaining, (MAX_LOOSE_BLOCKS/2)*LAZY_BLOCK_SIZE)))
+			I_Error("Could not fetch %s", Path.GetChars());
+		Touch(block);
+
+		const long offset = FilePos%LAZY_BLOCK_SIZE;
+		const long size = MIN<long>(LAZY_BLOCK_SIZE - offset, remaining);
+		memcpy(out, Blocks[block] + offset, size);
+		out += size;
+		FilePos += size;
+		remaining -= size;
+	}
+	return len;
+}
+
+char *FLazyFileReader::Gets(char *strbuf, int len)
+{
+	if(len <= 0 || FilePos >= Length)
+		return NULL;
+
+	char *p = strbuf;
+	while(--len > 0 && FilePos < Length)
+	{
+		Read(p, 1);
+		if(*p++ == '\n')
+			break;
+	}
+	*p = 0;
+	return strbuf;
+}
@@ -0,0 +1,79 @@
+/*
+** lazyfile.h
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Reader for archives which are fetched over HTTP a block at a time as they
+** are read. The frontend registers them through Module.lazyFiles (see
+** js/lazyFiles.js) which leaves an empty placeholder in the filesystem.
+**
+*/
+
+#ifndef __LAZYFILE_H__
+#define __LAZYFILE_H__
+
+#include "files.h"
+#include "tarray.h"
+#include "zstring.h"
+
+class FLazyFileReader : public FileReader
+{
+public:
+	// Returns NULL if the file isn't a lazy placeholder.
+	static FLazyFileReader *Open(const char *filename);
+
+	~FLazyFileReader();
+
+	long Tell() const;
+	long Seek(long offset, int origin);
+	long Read(void *buffer, long len);
+	char *Gets(char *strbuf, int len);
+
+	// Fetches the given range if it isn't already available.
+	bool Prefetch(long start, long len);
+
+	// Fetches the whole file and keeps it in memory for the life of the
+	// reader.
+	bool Preload();
+
+private:
+	FLazyFileReader(const char *filename, long length);
+
+	void Touch(unsigned int block);
+	void TrimBlocks(unsigned int first, unsigned int last);
+
+	FString Path;
+	TArray<BYTE *> Blocks;
+	TArray<unsigned int> LastUse;	// BLOCK_KEPT if the block is never freed
+	unsigned int UseCount;
+	unsigned int NumLoose;	// Loaded blocks which may be freed
+	bool Keeping;
+};
+
+#endif
@@ -136,10 +136,6 @@ static inline void SWAP_FLOAT(float &x)
 }
 #endif
 
-// Output buffer size for compression; need some extra space.
-// I assume the description in zlib.h is accurate.
-#define OUT_LEN(a)		((a) + (a) / 1000 + 12)
-
 void FCompressedFile::BeEmpty ()
 {
 	m_Pos = 0;
@@ -366,6 +362,26 @@ FFile &FCompressedFile::Seek (int pos, ESeekPos ofs)
 
 //CVAR (Bool, nofilecompression, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 static const bool nofilecompression = false;
+// Snapshots are mostly repeated texture names and zeroed spot state which
+// compress nearly as well at the fastest level as at the default one.
+static const int filecompressionlevel = Z_BEST_SPEED;
+
+//==========================================================================
+//
+// FCompressedFile :: Reserve
+//
+// Makes sure that at least size bytes can be written without reallocating.
+//
+//==========================================================================
+
+void FCompressedFile::Reserve (unsigned int size)
+{
+	if (m_Mode == EWriting && size > m_MaxBufferSize)
+	{
+		m_MaxBufferSize = size;
+		m_Buffer = (BYTE *)M_Realloc (m_Buffer, m_MaxBufferSize);
+	}
+}
 
 void FCompressedFile::Implode ()
 {
@@ -377,17 +393,9 @@ void FCompressedFile::Implode ()
 
 	if (!nofilecompression && !m_NoCompress)
 	{
-		outlen = OUT_LEN(len);
-		do
-		{
-			compressed = new Bytef[outlen];
-			r = compress (compressed, &outlen, m_Buffer, len);
-			if (r == Z_BUF_ERROR)
-			{
-				delete[] compressed;
-				outlen += 1024;
-			}
-		} while (r == Z_BUF_ERROR);
+		outlen = compressBound (len);
+		compressed = new Bytef[outlen];
+		r = compress2 (compressed, &outlen, m_Buffer, len, filecompressionlevel);
 
 		// If the data could not be compressed, store it as-is.
 		if (r != Z_OK || outlen >= len)
@@ -624,6 +632,79 @@ void FCompressedMemFile::GetSizes(unsigned int &compressed, unsigned int &uncomp
 	}
 }
 
+// When writing the buffer is emptied, but its storage is kept so that
+// repeated snapshots of similar size don't need to reallocate.
+FMemFile::FMemFile (TArray<BYTE> &buffer, EOpenMode mode)
+	: m_Buffer (buffer), m_Pos (0), m_Mode (mode)
+{
+	if (m_Mode == EWriting)
+		m_Buffer.Clear ();
+}
+
+FMemFile::~FMemFile ()
+{
+	Close ();
+}
+
+bool FMemFile::Open (const char *name, EOpenMode mode)
+{
+	I_Error ("FMemFile can not be used with files on disk");
+	return false;
+}
+
+void FMemFile::Close ()
+{
+	m_Mode = ENotOpen;
+	m_Pos = 0;
+}
+
+FFile &FMemFile::Write (const void *mem, unsigned int len)
+{
+	if (m_Mode != EWriting)
+		I_Error ("Tried to write to reading memfile");
+
+	if (m_Pos + len > m_Buffer.Size())
+		m_Buffer.Reserve (m_Pos + len - m_Buffer.Size());
+	if (len == 1)
+		m_Buffer[m_Pos] = *(const BYTE *)mem;
+	else
+		memcpy (&m_Buffer[m_Pos], mem, len);
+	m_Pos += len;
+	return *this;
+}
+
+FFile &FMemFile::Read (void *mem, unsigned int len)
+{
+	if (m_Mode != EReading)
+		I_Error ("Tried to read from writing memfile");
+	if (m_Pos + len > m_Buffer.Size())
+		I_Error ("Attempt to read past end of memfile");
+
+	if (len == 1)
+		*(BYTE *)mem = m_Buffer[m_Pos];
+	else
+		memcpy (mem, &m_Buffer[m_Pos], len);
+	m_Pos += len;
+	return *this;
+}
+
+FFile &FMemFile::Seek (int pos, ESeekPos ofs)
+{
+	if (ofs == ESeekRelative)
+		pos += m_Pos;
+	else if (ofs == ESeekEnd)
+		pos = m_Buffer.Size() - pos;
+
+	if (pos < 0)
+		m_Pos = 0;
+	else if ((unsigned)pos > m_Buffer.Size())
+		m_Pos = m_Buffer.Size();
+	else
+		m_Pos = pos;
+
+	return *this;
+}
+
 FPNGChunkFile::FPNGChunkFile (FILE *file, DWORD id)
 	: FCompressedFile (file, EWriting, true, false), m_ChunkID (id)
 {
@@ -940,29 +1021,109 @@ FArchive &FArchive::operator<< (FString &str)
 
 FArchive& FArchive::StoreInt(void *p, size_t sz)
 {
+	// Archives that never leave the process don't need a defined byte order.
+	if (!m_Persistent)
+	{
+		if (m_Storing)
+			Write (p, (unsigned int)sz);
+		else
+			Read (p, (unsigned int)sz);
+		return *this;
+	}
+
 #ifdef __BIG_ENDIAN__
   	if (m_Storing)
 		Write (p, sz);
 	else
 		Read (p, sz);
 #else
-	union {
-		unsigned long long ull;
-		unsigned char b[8];
-	} buffer;
-  	if (m_Storing) {
-		for (size_t i = 0; i < sz; i++)
-			buffer.b[i] = ((unsigned char *)p)[sz - i - 1];
-		Write (buffer.b, sz);
-	} else {
-		Read (buffer.b, sz);
-		for (size_t i = 0; i < sz; i++)
-			((unsigned char *)p)[sz - i - 1] = buffer.b[i];
+	if (m_Storing)
+	{
+		switch (sz)
+		{
+		case 1: Write (p, 1); break;
+		case 2: { WORD w = SWAP_WORD(*(WORD *)p); Write (&w, 2); break; }
+		case 4: { DWORD d = SWAP_DWORD(*(DWORD *)p); Write (&d, 4); break; }
+		case 8: { QWORD q = SWAP_QWORD(*(QWORD *)p); Write (&q, 8); break; }
+		default: I_Error ("Can't store integer of size %u", (unsigned int)sz);
+		}
+	}
+	else
+	{
+		Read (p, (unsigned int)sz);
+		switch (sz)
+		{
+		case 1: break;
+		case 2: *(WORD *)p = SWAP_WORD(*(WORD *)p); break;
+		case 4: *(DWORD *)p = SWAP_DWORD(*(DWORD *)p); break;
+		case 8: *(QWORD *)p = SWAP_QWORD(*(QWORD *)p); break;
+		default: I_Error ("Can't load integer of size %u", (unsigned int)sz);
+		}
 	}
 #endif
 	return *this;
 }
 
+//==========================================================================
+//
+// FArchive :: StoreIntArray
+//
+// Serializes count integers of size sz in one go. On little endian
+// machines the data is swapped in a single pass over a bounce buffer (when
+// storing) or in place (when loading) instead of one element at a time.
+//
+//==========================================================================
+
+FArchive& FArchive::StoreIntArray(void *p, size_t sz, unsigned int count)
+{
+	const unsigned int len = (unsigned int)(sz*count);
+
+#ifndef __BIG_ENDIAN__
+	if (m_Persistent && sz > 1)
+	{
+		if (m_Storing)
+		{
+			// Swap in chunks so that we don't need to touch the source.
+			QWORD bounce[64];
+			const unsigned int perChunk = (unsigned int)(sizeof(bounce)/sz);
+			BYTE *src = (BYTE *)p;
+			while (count > 0)
+			{
+				const unsigned int num = MIN(count, perChunk);
+				switch (sz)
+				{
+				case 2: for (unsigned int i = 0;i < num;++i) ((WORD *)bounce)[i] = SWAP_WORD(((WORD *)src)[i]); break;
+				case 4: for (unsigned int i = 0;i < num;++i) ((DWORD *)bounce)[i] = SWAP_DWORD(((DWORD *)src)[i]); break;
+				case 8: for (unsigned int i = 0;i < num;++i) bounce[i] = SWAP_QWORD(((QWORD *)src)[i]); break;
+				default: I_Error ("Can't store integer of size %u", (unsigned int)sz);
+				}
+				Write (bounce, (unsigned int)(num*sz));
+				src += num*sz;
+				count -= num;
+			}
+		}
+		else
+		{
+			Read (p, len);
+			switch (sz)
+			{
+			case 2: for (unsigned int i = 0;i < count;++i) ((WORD *)p)[i] = SWAP_WORD(((WORD *)p)[i]); break;
+			case 4: for (unsigned int i = 0;i < count;++i) ((DWORD *)p)[i] = SWAP_DWORD(((DWORD *)p)[i]); break;
+			case 8: for (unsigned int i = 0;i < count;++i) ((QWORD *)p)[i] = SWAP_QWORD(((QWORD *)p)[i]); break;
+			default: I_Error ("Can't load integer of size %u", (unsigned int)sz);
+			}
+		}
+		return *this;
+	}
+#endif
+
+	if (m_Storing)
+		Write (p, len);
+	else
+		Read (p, len);
+	return *this;
+}
+
 FArchive &FArchive::operator<< (float &w)
 {
 	if (m_Storing)
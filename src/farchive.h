@@ -92,6 +92,7 @@ public:
 	bool IsPersistent () const { return true; }
 	bool IsOpen () const;
 	unsigned int GetSize () const { return m_BufferSize; }
+	void Reserve (unsigned int size);
 
 	FFile &Write (const void *, unsigned int);
 	FFile &Read (void *, unsigned int);
@@ -141,6 +142,33 @@ private:
 	unsigned char *m_ImplodedBuffer;
 };
 
+// Uncompressed memory file used for snapshots that never leave the running
+// process. Since it isn't persistent, archives attached to it store integers
+// in native byte order.
+class FMemFile : public FFile
+{
+public:
+	FMemFile (TArray<BYTE> &buffer, EOpenMode mode);
+	~FMemFile ();
+
+	bool Open (const char *name, EOpenMode mode);
+	void Close ();
+	void Flush () {}
+	EOpenMode Mode () const { return m_Mode; }
+	bool IsPersistent () const { return false; }
+	bool IsOpen () const { return m_Mode != ENotOpen; }
+
+	FFile &Write (const void *, unsigned int);
+	FFile &Read (void *, unsigned int);
+	unsigned int Tell () const { return m_Pos; }
+	FFile &Seek (int, ESeekPos);
+
+private:
+	TArray<BYTE> &m_Buffer;
+	unsigned int m_Pos;
+	EOpenMode m_Mode;
+};
+
 class FPNGChunkFile : public FCompressedFile
 {
 public:
@@ -178,6 +206,12 @@ virtual void Read (void *mem, unsigned int len);
 		void UserReadClass (const ClassDef *&info);
 
 	        FArchive& StoreInt(void *p, size_t sz);
+	        FArchive& StoreIntArray(void *p, size_t sz, unsigned int count);
+
+	// Serializes a fixed size array of integers with a single read or write.
+	// The stored layout is identical to serializing each element in turn.
+	template<typename T, size_t N>
+	inline FArchive& StoreIntArray(T (&arr)[N]) { return StoreIntArray(arr, sizeof(T), N); }
 
 #define INT_OPERATOR(type) inline FArchive& operator<< (type &v) { return StoreInt(&v, sizeof(v)); }
 
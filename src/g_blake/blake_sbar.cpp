@@ -57,7 +57,10 @@ enum
 class BlakeStatusBar : public DBaseStatusBar
 {
 public:
-	BlakeStatusBar() : CurrentScore(0) {}
+	BlakeStatusBar() : CurrentScore(0)
+	{
+		memset(&LastState, 0, sizeof(LastState));
+	}
 
 	void DrawStatusBar();
 	unsigned int GetHeight(bool top)
@@ -75,11 +78,25 @@ public:
 	void Tick();
 
 protected:
+	// Everything the status bar shows. It only needs to be redrawn when this
+	// changes or something else draws over it.
+	struct DrawnState
+	{
+		const LevelInfo *level;
+		int viewsize;
+		int lives, health, score;
+		int weapon, ammo, maxammo;
+		int radar, maxradar;
+		int keys;
+	};
+
 	void DrawLed(double percent, double x, double y) const;
 	void DrawString(FFont *font, const char* string, double x, double y, bool shadow, EColorRange color=CR_UNTRANSLATED, bool center=false) const;
+	void GetDrawnState(DrawnState &state) const;
 
 private:
 	int CurrentScore;
+	DrawnState LastState;
 };
 
 DBaseStatusBar *CreateStatusBar_Blake() { return new BlakeStatusBar(); }
@@ -117,11 +134,58 @@ void BlakeStatusBar::DrawLed(double percent, double x, double y) const
 		TAG_DONE);
 }
 
+void BlakeStatusBar::GetDrawnState(DrawnState &state) const
+{
+	memset(&state, 0, sizeof(state));
+	state.level = levelInfo;
+	state.viewsize = viewsize;
+	state.lives = players[ConsolePlayer].lives;
+	state.health = players[ConsolePlayer].health;
+	state.score = CurrentScore;
+
+	if(players[ConsolePlayer].ReadyWeapon)
+	{
+		state.weapon = players[ConsolePlayer].ReadyWeapon->icon.GetIndex();
+		state.ammo = players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire]->amount;
+		state.maxammo = players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire]->maxamount;
+	}
+
+	if(players[ConsolePlayer].mo)
+	{
+		static const ClassDef * const radarPackCls = ClassDef::FindClass("RadarPack");
+		AInventory *radarPack = players[ConsolePlayer].mo->FindInventory(radarPackCls);
+		if(radarPack)
+		{
+			state.radar = radarPack->amount;
+			state.maxradar = radarPack->maxamount;
+		}
+
+		// Find keys in inventory
+		for(AInventory *item = players[ConsolePlayer].mo->inventory;item != NULL;item = item->inventory)
+		{
+			if(item->IsKindOf(NATIVE_CLASS(Key)))
+			{
+				int slot = static_cast<AKey *>(item)->KeyNumber;
+				if(slot <= 3)
+					state.keys |= 1<<(slot-1);
+				if(state.keys == 0x7)
+					break;
+			}
+		}
+	}
+}
+
 void BlakeStatusBar::DrawStatusBar()
 {
 	if(viewsize == 21 && ingame)
 		return;
 
+	DrawnState state;
+	GetDrawnState(state);
+	if(!screen->IsWatchedAreaDirty() && memcmp(&state, &LastState, sizeof(state)) == 0)
+		return;
+	LastState = state;
+
 	static FFont *IndexFont = V_GetFont("INDEXFON");
 	static FFont *HealthFont = V_GetFont("BlakeHealthFont");
 	static FFont *ScoreFont = V_GetFont("BlakeScoreFont");
@@ -168,6 +232,16 @@ void BlakeStatusBar::DrawStatusBar()
 		VWB_Clear(colors[0], scaleFactorX, boty-scaleFactorY, screenWidth, boty);
 		VWB_Clear(colors[0], screenWidth-scaleFactorX, topy, screenWidth, static_cast<int>(boty-scaleFactorY));
 	}
+	screen->ResetWatchedAreas();
+	screen->WatchArea(0, 0, screenWidth, topy);
+	screen->WatchArea(0, boty, screenWidth, screenHeight);
+	if(viewsize < 20)
+	{
+		screen->WatchArea(0, topy, screenWidth, topy+scaleFactorY);
+		screen->WatchArea(0, boty-scaleFactorY, screenWidth, boty);
+		screen->WatchArea(0, topy, scaleFactorX, boty);
+		screen->WatchArea(screenWidth-scaleFactorX, topy, screenWidth, boty);
+	}
 
 	// Draw the top information
 	FString lives, area;
@@ -176,14 +250,14 @@ void BlakeStatusBar::DrawStatusBar()
 		area = "SECRET";
 	else
 		area.Format("AREA: %d", levelInfo->LevelNumber);
-	lives.Format("LIVES: %d", players[ConsolePlayer].lives);
+	lives.Format("LIVES: %d", state.lives);
 	DrawString(IndexFont, area, 18, 5, true, CR_WHITE);
 	DrawString(IndexFont, levelInfo->GetName(map), 160, 5, true, CR_WHITE, true);
 	DrawString(IndexFont, lives, 267, 5, true, CR_WHITE);
 
 	// Draw bottom information
 	FString health;
-	health.Format("%3d", players[ConsolePlayer].health);
+	health.Format("%3d", state.health);
 	DrawString(HealthFont, health, 128, 162, false);
 
 	FString score;
@@ -207,41 +281,21 @@ void BlakeStatusBar::DrawStatusBar()
 		}
 
 		// TODO: Fix color
-		unsigned int amount = players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire]->amount;
-		DrawLed(static_cast<double>(amount)/static_cast<double>(players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire]->maxamount), 243, 155);
+		DrawLed(static_cast<double>(state.ammo)/static_cast<double>(state.maxammo), 243, 155);
 
 		FString ammo;
-		ammo.Format("%3d%%", amount);
+		ammo.Format("%3d%%", state.ammo);
 		DrawString(IndexFont, ammo, 252, 190, false, CR_LIGHTBLUE);
 	}
 
 	if(players[ConsolePlayer].mo)
 	{
-		static const ClassDef * const radarPackCls = ClassDef::FindClass("RadarPack");
-		AInventory *radarPack = players[ConsolePlayer].mo->FindInventory(radarPackCls);
-		if(radarPack)
-			DrawLed(static_cast<double>(radarPack->amount)/static_cast<double>(radarPack->maxamount), 235, 155);
+		if(state.maxradar)
+			DrawLed(static_cast<double>(state.radar)/static_cast<double>(state.maxradar), 235, 155);
 		else
 			DrawLed(0, 235, 155);
 	}
 
-	// Find keys in inventory
-	int presentKeys = 0;
-	if(players[ConsolePlayer].mo)
-	{
-		for(AInventory *item = players[ConsolePlayer].mo->inventory;item != NULL;item = item->inventory)
-		{
-			if(item->IsKindOf(NATIVE_CLASS(Key)))
-			{
-				int slot = static_cast<AKey *>(item)->KeyNumber;
-				if(slot <= 3)
-					presentKeys |= 1<<(slot-1);
-				if(presentKeys == 0x7)
-					break;
-			}
-		}
-	}
-
 	static FTextureID Keys[4] = {
 		TexMan.GetTexture("STKEYS0", FTexture::TEX_Any),
 		TexMan.GetTexture("STKEYS1", FTexture::TEX_Any),
@@ -251,7 +305,7 @@ void BlakeStatusBar::DrawStatusBar()
 	for(unsigned int i = 0;i < 3;++i)
 	{
 		FTexture *tex;
-		if(presentKeys & (1<<i))
+		if(state.keys & (1<<i))
 			tex = TexMan(Keys[i+1]);
 		else
 			tex = TexMan(Keys[0]);
@@ -6,6 +6,8 @@
 #include "wl_game.h"
 #include "wl_play.h"
 #include "textures/textures.h"
+#include "v_textrun.h"
+#include "v_video.h"
 #include "id_ca.h"
 #include "id_us.h"
 #include "id_vh.h"
@@ -58,8 +60,11 @@ static struct StatusBarConfig_t
 class WolfStatusBar : public DBaseStatusBar
 {
 public:
-	WolfStatusBar() : facecount(0), mac(false)
+	WolfStatusBar() : facecount(0), mac(false), curWidget(NULL), refresh(true)
 	{
+		for(unsigned int i = 0;i < NUM_WIDGETS;++i)
+			widgets[i].drawn = false;
+
 		if(IWad::CheckGameFilter("Noah"))
 		{
 			// Change default configuration
@@ -103,10 +108,32 @@ public:
 	void WeaponGrin();
 
 private:
-	static void LatchNumber (int x, int y, unsigned width, int32_t number, bool zerofill, bool cap=false);
-	static void LatchString (int x, int y, unsigned width, const FString &str);
-	static void StatusDrawFace(FTexture *pic);
-	static void StatusDrawPic(unsigned x, unsigned y, const char* pic);
+	enum EWidget
+	{
+		SB_Face, SB_Health, SB_Lives, SB_Level, SB_Ammo,
+		SB_Keys, SB_Weapon, SB_Score, SB_Items,
+
+		NUM_WIDGETS
+	};
+
+	// What a widget last drew and the area it covered (in 320x200
+	// coordinates) so that it only needs to be repainted on change.
+	struct Widget
+	{
+		bool drawn;
+		intptr_t value;
+		double x1, y1, x2, y2;
+	};
+
+	bool BeginWidget(EWidget id, bool visible, intptr_t value=0);
+	void DrawWidgetGraphic(FTexture *tex, int x, int y);
+	void RestoreBackground(const Widget &widget);
+	bool WidgetsOverlap() const;
+
+	void LatchNumber (int x, int y, unsigned width, int32_t number, bool zerofill, bool cap=false);
+	void LatchString (int x, int y, unsigned width, const FString &str);
+	void StatusDrawFace(FTexture *pic);
+	void StatusDrawPic(unsigned x, unsigned y, const char* pic);
 
 	void DrawAmmo();
 	void DrawFace();
@@ -121,10 +148,106 @@ private:
 
 	int facecount;
 	bool mac;
+
+	Widget widgets[NUM_WIDGETS];
+	Widget *curWidget;
+	bool refresh;
 };
 
 DBaseStatusBar *CreateStatusBar_Wolf3D() { return new WolfStatusBar(); }
 
+/*
+==================
+=
+= BeginWidget
+=
+= Returns true if the widget needs to be drawn. If it changed since the
+= last time the old contents are cleared first.
+=
+==================
+*/
+
+bool WolfStatusBar::BeginWidget (EWidget id, bool visible, intptr_t value)
+{
+	Widget &widget = widgets[id];
+	if(!refresh)
+	{
+		if(widget.drawn == visible && (!visible || widget.value == value))
+			return false;
+
+		if(widget.drawn)
+			RestoreBackground(widget);
+	}
+
+	widget.drawn = visible;
+	widget.value = value;
+	widget.x1 = widget.y1 = INT_MAX;
+	widget.x2 = widget.y2 = INT_MIN;
+	curWidget = &widget;
+	return visible;
+}
+
+void WolfStatusBar::DrawWidgetGraphic (FTexture *tex, int x, int y)
+{
+	if(!tex)
+		return;
+
+	VWB_DrawGraphic(tex, x, y);
+
+	if(curWidget)
+	{
+		const double left = x - tex->GetScaledLeftOffsetDouble();
+		const double top = y - tex->GetScaledTopOffsetDouble();
+		curWidget->x1 = MIN(curWidget->x1, left);
+		curWidget->y1 = MIN(curWidget->y1, top);
+		curWidget->x2 = MAX(curWidget->x2, left + tex->GetScaledWidthDouble());
+		curWidget->y2 = MAX(curWidget->y2, top + tex->GetScaledHeightDouble());
+	}
+}
+
+void WolfStatusBar::RestoreBackground (const Widget &widget)
+{
+	if(widget.x1 >= widget.x2 || widget.y1 >= widget.y2)
+		return;
+
+	double x = widget.x1, y = widget.y1, w = widget.x2 - widget.x1, h = widget.y2 - widget.y1;
+	screen->VirtualToRealCoords(x, y, w, h, 320, 200, true, true);
+
+	FTexture *stbar = TexMan("STBAR");
+	double bx = 0, by = 160, bw = stbar->GetScaledWidthDouble(), bh = stbar->GetScaledHeightDouble();
+	screen->VirtualToRealCoords(bx, by, bw, bh, 320, 200, true, true);
+
+	screen->Lock(false);
+	screen->DrawTexture(stbar, bx, by,
+		DTA_DestWidthF, bw,
+		DTA_DestHeightF, bh,
+		DTA_ClipLeft, int(floor(x)),
+		DTA_ClipTop, int(floor(y)),
+		DTA_ClipRight, int(ceil(x + w)),
+		DTA_ClipBottom, int(ceil(y + h)),
+		TAG_DONE);
+	screen->Unlock();
+}
+
+// Clearing one widget would erase part of another, so just redraw everything
+bool WolfStatusBar::WidgetsOverlap () const
+{
+	for(unsigned int i = 0;i < NUM_WIDGETS;++i)
+	{
+		const Widget &a = widgets[i];
+		if(!a.drawn)
+			continue;
+
+		for(unsigned int j = i+1;j < NUM_WIDGETS;++j)
+		{
+			const Widget &b = widgets[j];
+			if(b.drawn && a.x1 < b.x2 && b.x1 < a.x2 && a.y1 < b.y2 && b.y1 < a.y2)
+				return true;
+		}
+	}
+	return false;
+}
+
 /*
 ==================
 =
@@ -135,12 +258,12 @@ DBaseStatusBar *CreateStatusBar_Wolf3D() { return new WolfStatusBar(); }
 
 void WolfStatusBar::StatusDrawPic (unsigned x, unsigned y, const char* pic)
 {
-	VWB_DrawGraphic(TexMan(pic), x, 200-(STATUSLINES-y));
+	DrawWidgetGraphic(TexMan(pic), x, 200-(STATUSLINES-y));
 }
 
 void WolfStatusBar::StatusDrawFace(FTexture *pic)
 {
-	VWB_DrawGraphic(pic, StatusBarConfig.Mugshot.X, 200-(STATUSLINES-StatusBarConfig.Mugshot.Y));
+	DrawWidgetGraphic(pic, StatusBarConfig.Mugshot.X, 200-(STATUSLINES-StatusBarConfig.Mugshot.Y));
 }
 
 
@@ -162,8 +285,9 @@ void WolfStatusBar::DrawFace (void)
 		UpdateFace();
 	}
 
+	FTexture *pic;
 	if (players[ConsolePlayer].health)
-		StatusDrawFace(TexMan(gamestate.faceframe));
+		pic = TexMan(gamestate.faceframe);
 	else
 	{
 		// TODO: Make this work based on damage types.
@@ -172,10 +296,13 @@ void WolfStatusBar::DrawFace (void)
 		// these days I'll get damage types in!
 		static const ClassDef *schabbs = ClassDef::FindClass("Schabbs");
 		if (players[ConsolePlayer].killerobj && players[ConsolePlayer].killerobj->IsKindOf(schabbs))
-			StatusDrawFace(TexMan("STFMUT0"));
+			pic = TexMan("STFMUT0");
 		else
-			StatusDrawFace(TexMan("STFDEAD0"));
+			pic = TexMan("STFDEAD0");
 	}
+
+	if(BeginWidget(SB_Face, true, (intptr_t)pic))
+		StatusDrawFace(pic);
 }
 
 /*
@@ -320,12 +447,21 @@ void WolfStatusBar::LatchString (int x, int y, unsigned width, const FString &st
 
 	y = 200-(STATUSLINES-y);// + HudFont->GetHeight();
 
-	int cwidth;
-	FRemapTable *remap = HudFont->GetColorTranslation(CR_UNTRANSLATED);
-	for(unsigned int i = MAX<int>(0, (int)(str.Len()-width));i < str.Len();++i)
+	double rx = x, ry = y, scalex = 1, scaley = 1;
+	screen->VirtualToRealCoords(rx, ry, scalex, scaley, 320, 200, true, true);
+
+	const unsigned int start = MAX<int>(0, (int)(str.Len()-width));
+	screen->Lock(false);
+	FTextRunBox box = V_DrawTextRun(screen, FTextRunStyle(HudFont, CR_UNTRANSLATED, scalex, scaley),
+		rx, ry, str.GetChars()+start, str.Len()-start);
+	screen->Unlock();
+
+	if(curWidget && box.x1 < box.x2)
 	{
-		VWB_DrawGraphic(HudFont->GetChar(str[i], &cwidth), x, y, MENU_NONE, remap);
-		x += cwidth;
+		curWidget->x1 = MIN(curWidget->x1, x + box.x1);
+		curWidget->y1 = MIN(curWidget->y1, y + box.y1);
+		curWidget->x2 = MAX(curWidget->x2, x + box.x2);
+		curWidget->y2 = MAX(curWidget->y2, y + box.y2);
 	}
 }
 
@@ -341,6 +477,7 @@ void WolfStatusBar::LatchString (int x, int y, unsigned width, const FString &st
 void WolfStatusBar::DrawHealth (void)
 {
 	if((viewsize == 21 && ingame) || !StatusBarConfig.Health.Enabled) return;
+	if(!BeginWidget(SB_Health, true, players[ConsolePlayer].health)) return;
 	LatchNumber (StatusBarConfig.Health.X,StatusBarConfig.Health.Y,StatusBarConfig.Health.Digits,players[ConsolePlayer].health,mac,true);
 }
 
@@ -358,6 +495,7 @@ void WolfStatusBar::DrawHealth (void)
 void WolfStatusBar::DrawLevel (void)
 {
 	if((viewsize == 21 && ingame) || !StatusBarConfig.Floor.Enabled) return;
+	if(!BeginWidget(SB_Level, true, (intptr_t)levelInfo)) return;
 	FString str;
 	str.Format("%*s", StatusBarConfig.Floor.Digits, levelInfo->FloorNumber.GetChars());
 	LatchString (StatusBarConfig.Floor.X,StatusBarConfig.Floor.Y,StatusBarConfig.Floor.Digits,str);
@@ -377,6 +515,7 @@ void WolfStatusBar::DrawLevel (void)
 void WolfStatusBar::DrawLives (void)
 {
 	if((viewsize == 21 && ingame) || (!StatusBarConfig.Lives.Enabled) || (gamestate.difficulty->LivesCount < 0)) return;
+	if(!BeginWidget(SB_Lives, true, players[ConsolePlayer].lives)) return;
 	LatchNumber (StatusBarConfig.Lives.X,StatusBarConfig.Lives.Y,StatusBarConfig.Lives.Digits,players[ConsolePlayer].lives,mac);
 }
 
@@ -393,12 +532,16 @@ void WolfStatusBar::DrawLives (void)
 
 void WolfStatusBar::DrawItems (void)
 {
-	if((viewsize == 21 && ingame) || !StatusBarConfig.Items.Enabled || players[ConsolePlayer].mo == NULL) return;
+	if((viewsize == 21 && ingame) || !StatusBarConfig.Items.Enabled) return;
 
-	AInventory *items = players[ConsolePlayer].mo->FindInventory(ClassDef::FindClass("MacTreasureItem"));
 	unsigned int amount = 0;
-	if(items)
-		amount = items->amount;
+	if(players[ConsolePlayer].mo)
+	{
+		AInventory *items = players[ConsolePlayer].mo->FindInventory(ClassDef::FindClass("MacTreasureItem"));
+		if(items)
+			amount = items->amount;
+	}
+	if(!BeginWidget(SB_Items, players[ConsolePlayer].mo != NULL, amount)) return;
 
 	LatchNumber (StatusBarConfig.Items.X,StatusBarConfig.Items.Y,StatusBarConfig.Items.Digits,amount,mac);
 }
@@ -421,6 +564,7 @@ void WolfStatusBar::DrawScore (void)
 	if(Net::InitVars.gameMode == Net::GM_Battle)
 		score = players[ConsolePlayer].frags;
 
+	if(!BeginWidget(SB_Score, true, score)) return;
 	LatchNumber (StatusBarConfig.Score.X,StatusBarConfig.Score.Y,StatusBarConfig.Score.Digits,score,mac);
 }
 
@@ -436,13 +580,15 @@ void WolfStatusBar::DrawScore (void)
 
 void WolfStatusBar::DrawWeapon (void)
 {
-	if((viewsize == 21 && ingame) || !StatusBarConfig.Weapon.Enabled ||
-		players[ConsolePlayer].ReadyWeapon == NULL ||
-		players[ConsolePlayer].ReadyWeapon->icon.isNull()
-	)
+	if((viewsize == 21 && ingame) || !StatusBarConfig.Weapon.Enabled)
 		return;
 
-	VWB_DrawGraphic(TexMan(players[ConsolePlayer].ReadyWeapon->icon), StatusBarConfig.Weapon.X, 200-(STATUSLINES-StatusBarConfig.Weapon.Y));
+	const bool visible = players[ConsolePlayer].ReadyWeapon != NULL &&
+		!players[ConsolePlayer].ReadyWeapon->icon.isNull();
+	if(!BeginWidget(SB_Weapon, visible, visible ? players[ConsolePlayer].ReadyWeapon->icon.GetIndex() : 0))
+		return;
+
+	DrawWidgetGraphic(TexMan(players[ConsolePlayer].ReadyWeapon->icon), StatusBarConfig.Weapon.X, 200-(STATUSLINES-StatusBarConfig.Weapon.Y));
 }
 
 
@@ -477,6 +623,9 @@ void WolfStatusBar::DrawKeys (void)
 		}
 	}
 
+	if(!BeginWidget(SB_Keys, true, presentKeys))
+		return;
+
 	const unsigned int x = StatusBarConfig.Keys.X;
 	unsigned int y = StatusBarConfig.Keys.Y;
 	if (extendedKeysGraphics && (presentKeys & (1|4)) == (1|4))
@@ -511,11 +660,14 @@ void WolfStatusBar::DrawKeys (void)
 
 void WolfStatusBar::DrawAmmo (void)
 {
-	if((viewsize == 21 && ingame) || !StatusBarConfig.Ammo.Enabled ||
-		!players[ConsolePlayer].ReadyWeapon || !players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire])
+	if((viewsize == 21 && ingame) || !StatusBarConfig.Ammo.Enabled)
+		return;
+
+	const bool visible = players[ConsolePlayer].ReadyWeapon && players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire];
+	unsigned int amount = visible ? players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire]->amount : 0;
+	if(!BeginWidget(SB_Ammo, visible, amount))
 		return;
 
-	unsigned int amount = players[ConsolePlayer].ReadyWeapon->ammo[AWeapon::PrimaryFire]->amount;
 	LatchNumber (StatusBarConfig.Ammo.X,StatusBarConfig.Ammo.Y,StatusBarConfig.Ammo.Digits,amount,mac,true);
 }
 
@@ -536,7 +688,12 @@ void WolfStatusBar::DrawStatusBar()
 	if(viewsize == 21 && ingame)
 		return;
 
-	VWB_DrawGraphic(TexMan("STBAR"), 0, 160);
+	// Widgets only repaint when what they show changes, unless something
+	// else drew over the status bar since last time.
+	refresh = screen->IsWatchedAreaDirty() || WidgetsOverlap();
+	if(refresh)
+		VWB_DrawGraphic(TexMan("STBAR"), 0, 160);
+
 	DrawFace ();
 	DrawHealth ();
 	DrawLives ();
@@ -546,6 +703,12 @@ void WolfStatusBar::DrawStatusBar()
 	DrawWeapon ();
 	DrawScore ();
 	DrawItems ();
+	curWidget = NULL;
+
+	double x = 0, y = 200-STATUSLINES, w = 320, h = STATUSLINES;
+	screen->VirtualToRealCoords(x, y, w, h, 320, 200, true, true);
+	screen->ResetWatchedAreas();
+	screen->WatchArea(int(floor(x)), int(floor(y)), int(ceil(x + w)), int(ceil(y + h)));
 }
 
 //===========================================================================
@@ -84,6 +84,9 @@ GameMap::GameMap(const FString &map) : map(map), valid(false), isUWMF(false),
 {
 	lumps[0] = NULL;
 
+	// The map data may still be getting cached.
+	FinishPrefetch();
+
 	// Find the map
 	markerLump = Wads.CheckNumForName(map);
 
@@ -218,7 +221,10 @@ GameMap::~GameMap()
 		delete file;
 
 	for(unsigned int i = 0;i < planes.Size();++i)
+	{
 		delete[] planes[i].map;
+		delete[] planes[i].clip;
+	}
 	UnloadLinks();
 }
 
@@ -264,6 +270,46 @@ bool GameMap::CheckMapExists(const FString &map)
 	}
 }
 
+/* Binary maps can be expanded ahead of time so that loading them is mostly a
+ * matter of translating the planes. This is done in another thread when
+ * possible so it can be kicked off while the intermission is up. Only lumps
+ * flagged as thread safe are considered since other lumps may share a file
+ * reader with something the main thread is using.
+ */
+static SDL_Thread *PrefetchThread = NULL;
+
+static int PrefetchLump(void *data)
+{
+	delete Wads.ReopenLumpNum(static_cast<int>(reinterpret_cast<intptr_t>(data)));
+	return 0;
+}
+
+void GameMap::Prefetch(const FString &map)
+{
+	FinishPrefetch();
+
+	int lump = Wads.CheckNumForName(map);
+	if(lump == -1 || ++lump >= Wads.GetNumLumps())
+		return;
+
+	const char* lumpName = Wads.GetLumpFullName(lump);
+	if(lumpName == NULL || strcmp(lumpName, "PLANES") != 0 || !(Wads.GetLumpFlags(lump) & LUMPF_THREADSAFE))
+		return;
+
+	void *data = reinterpret_cast<void *>(static_cast<intptr_t>(lump));
+	if(!(PrefetchThread = SDL_CreateThread(PrefetchLump, "MapPrefetch", data)))
+		PrefetchLump(data);
+}
+
+void GameMap::FinishPrefetch()
+{
+	if(PrefetchThread)
+	{
+		SDL_WaitThread(PrefetchThread, NULL);
+		PrefetchThread = NULL;
+	}
+}
+
 bool GameMap::CheckLink(const Zone *zone1, const Zone *zone2, bool recurse)
 {
 	if(zone1 == NULL || zone2 == NULL)
@@ -475,6 +521,13 @@ void GameMap::LoadMap(bool loadingSave)
 	else
 		ReadPlanesData();
 
+	// The loaders modify spots directly so bring the clip data up to date.
+	for(unsigned int p = 0;p < planes.Size();++p)
+	{
+		for(unsigned int i = 0;i < header.width*header.height;++i)
+			planes[p].map[i].UpdateClip();
+	}
+
 	if(!loadingSave)
 		ScanTiles();
 }
@@ -485,8 +538,12 @@ GameMap::Plane &GameMap::NewPlane()
 	Plane &newPlane = planes[planes.Size()-1];
 	newPlane.gm = this;
 	newPlane.map = new Plane::Map[header.width*header.height];
+	newPlane.clip = new WORD[header.width*header.height];
 	for(unsigned int i = 0;i < header.width*header.height;++i)
+	{
 		newPlane.map[i].plane = &newPlane;
+		newPlane.map[i].UpdateClip();
+	}
 	return newPlane;
 }
 
@@ -735,6 +792,24 @@ void GameMap::Plane::Map::SetTile(const MapTile *tile)
 			texture[i].SetInvalid();
 		}
 	}
+	UpdateClip();
+}
+
+void GameMap::Plane::Map::UpdateClip() const
+{
+	WORD flags = 0;
+	if(tile)
+		flags |= CLIP_Tile;
+	if(pushAmount != 0)
+		flags |= CLIP_Pushing;
+	for(unsigned int i = 0;i < 4;++i)
+	{
+		if(slideAmount[i] == 0xffff)
+			flags |= CLIP_SideOpen<<i;
+		if(sideSolid[i])
+			flags |= CLIP_SideSolid<<i;
+	}
+	plane->clip[this - plane->map] = flags;
 }
 
 FArchive &operator<< (FArchive &arc, GameMap *&gm)
@@ -807,31 +882,41 @@ FArchive &operator<< (FArchive &arc, GameMap *&gm)
 		if(!arc.IsStoring())
 			plane.gm = gm;
 
-		for(unsigned int i = 0;i < gm->GetHeader().width*gm->GetHeader().height;++i)
+		// Hoist the version checks out of the loop since large maps have a
+		// lot of spots to go through.
+		const bool hasAmFlags = GameSave::SaveVersion >= 1393719642;
+		const bool hasSlideStyle = GameSave::SaveProdVersion >= 0x001002FF && GameSave::SaveVersion >= 1375246092;
+		const unsigned int numSpots = gm->GetHeader().width*gm->GetHeader().height;
+		for(unsigned int i = 0;i < numSpots;++i)
 		{
-			BYTE pushdir = plane.map[i].pushDirection;
+			MapSpot spot = &plane.map[i];
+
+			BYTE pushdir = spot->pushDirection;
 			arc << pushdir;
-			plane.map[i].pushDirection = static_cast<MapTile::Side>(pushdir);
-
-			arc << plane.map[i].texture[0] << plane.map[i].texture[1] << plane.map[i].texture[2] << plane.map[i].texture[3]
-				<< plane.map[i].visible;
-			if(GameSave::SaveVersion >= 1393719642)
-				arc << plane.map[i].amFlags;
-			arc << plane.map[i].thinker
-				<< plane.map[i].slideAmount[0] << plane.map[i].slideAmount[1] << plane.map[i].slideAmount[2] << plane.map[i].slideAmount[3]
-				<< plane.map[i].sideSolid[0] << plane.map[i].sideSolid[1] << plane.map[i].sideSolid[2] << plane.map[i].sideSolid[3]
-				<< plane.map[i].triggers
-				<< plane.map[i].pushAmount
-				<< plane.map[i].tile
-				<< plane.map[i].sector
-				<< plane.map[i].zone
-				<< plane.map[i].pushReceptor;
-
-			if(GameSave::SaveProdVersion >= 0x001002FF && GameSave::SaveVersion >= 1375246092)
-				arc << plane.map[i].slideStyle;
+			spot->pushDirection = static_cast<MapTile::Side>(pushdir);
+
+			arc << spot->texture[0] << spot->texture[1] << spot->texture[2] << spot->texture[3]
+				<< spot->visible;
+			if(hasAmFlags)
+				arc << spot->amFlags;
+			arc << spot->thinker;
+			arc.StoreIntArray(spot->slideAmount);
+			arc.StoreIntArray(spot->sideSolid);
+			arc << spot->triggers
+				<< spot->pushAmount
+				<< spot->tile
+				<< spot->sector
+				<< spot->zone
+				<< spot->pushReceptor;
+
+			if(hasSlideStyle)
+				arc << spot->slideStyle;
 
 			if(!arc.IsStoring())
-				plane.map[i].plane = &plane;
+			{
+				spot->plane = &plane;
+				spot->UpdateClip();
+			}
 		}
 	}
 
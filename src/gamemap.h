@@ -150,6 +150,16 @@ class GameMap
 		{
 			unsigned short	index;
 		};
+		// Compact copy of the parts of a spot that movement clipping and
+		// monster walking query constantly. Kept in an array parallel to the spots so that
+		// these checks don't need to pull whole spots into the cache.
+		enum ClipFlags
+		{
+			CLIP_Tile = 0x1,
+			CLIP_Pushing = 0x2,
+			CLIP_SideOpen = 0x10, // Shifted by Tile::Side, door is fully open
+			CLIP_SideSolid = 0x100 // Shifted by Tile::Side
+		};
 		struct Plane
 		{
 			const GameMap	*gm;
@@ -170,6 +180,7 @@ class GameMap
 				unsigned int	GetY() const;
 				Map				*GetAdjacent(Tile::Side dir, bool opposite=false) const;
 				void			SetTile(const Tile *tile);
+				void			UpdateClip() const;
 
 				const Plane		*plane;
 
@@ -194,6 +205,7 @@ class GameMap
 				unsigned int	tag;
 				Plane::Map		*nexttag;
 			}*	map;
+			WORD			*clip;
 		};
 		struct PlayerSpawn
 		{
@@ -207,6 +219,7 @@ class GameMap
 
 		bool			ActivateTrigger(Trigger &trig, Trigger::Side direction, AActor *activator);
 		void			ClearVisibility();
+		WORD			GetClip(unsigned int x, unsigned int y, unsigned int z) const { return GetPlane(z).clip[y*header.width+x]; }
 		const Header	&GetHeader() const { return header; }
 		void			GetHitlist(BYTE* hitlist) const;
 		int				GetMarketLumpNum() const { return markerLump; }
@@ -232,6 +245,8 @@ class GameMap
 		unsigned int	GetSectorIndex(const Sector *sector) const;
 
 		static bool		CheckMapExists(const FString &map);
+		static void		Prefetch(const FString &map);
+		static void		FinishPrefetch();
 
 		void PropagateMark();
 
@@ -15,8 +15,10 @@ loaded into the data segment
 */
 
 #include "actor.h"
+#include "doomerrors.h"
 #include "g_mapinfo.h"
 #include "gamemap.h"
+#include "textures/textures.h"
 #include "tmemory.h"
 #include "wl_def.h"
 #include "wl_game.h"
@@ -70,6 +72,19 @@ void CA_UnloadMap(GameMap *map)
 ======================
 */
 
+// Map built ahead of time by CA_UpdatePrefetch along with the level state
+// that building it would have changed.
+static FString PrefetchName;
+static FString PrefetchedName;
+static TUniquePtr<GameMap> PrefetchedMap;
+static struct
+{
+	short secrettotal;
+	fixed visibility;
+	fixed maxLightVis;
+	int light;
+} PrefetchedState;
+
 void CA_CacheMap (const FString &mapname, bool loading)
 {
 	static TUniquePtr<GameMap, TFuncDeleter<GameMap, CA_UnloadMap> > map;
@@ -79,11 +94,107 @@ void CA_CacheMap (const FString &mapname, bool loading)
 
 	strncpy(gamestate.mapname, mapname, 8);
 	levelInfo = &LevelInfo::Find(mapname);
-	::map = map = new GameMap(mapname);
-	map->LoadMap(loading);
+
+	PrefetchName = FString();
+	if(!loading && PrefetchedMap && PrefetchedName.CompareNoCase(mapname) == 0)
+	{
+		::map = map = PrefetchedMap.Release();
+		gamestate.secrettotal += PrefetchedState.secrettotal;
+		gLevelVisibility = PrefetchedState.visibility;
+		gLevelMaxLightVis = PrefetchedState.maxLightVis;
+		gLevelLight = PrefetchedState.light;
+	}
+	else
+	{
+		PrefetchedMap.Reset();
+		::map = map = new GameMap(mapname);
+		map->LoadMap(loading);
+	}
 
 	Printf("\n%s - %s\n\n", mapname.GetChars(), levelInfo->GetName(map).GetChars());
 
 	CalcVisibility(gLevelVisibility);
 }
 
+/*
+======================
+=
+= CA_PrefetchMap
+=
+= Marks the map that is likely to be loaded next. The data for it starts
+= expanding right away, but the map itself is only built by
+= CA_UpdatePrefetch once the caller has time to spare (the intermission).
+= Names which aren't maps, such as EndDemo or a victory sequence, are ignored.
+=
+======================
+*/
+
+// Frees a prefetched map which won't be used, for example when leaving the
+// game.
+void CA_ClearPrefetch ()
+{
+	PrefetchName = FString();
+	PrefetchedMap.Reset();
+}
+
+void CA_PrefetchMap (const FString &mapname)
+{
+	CA_ClearPrefetch();
+	if(!GameMap::CheckMapExists(mapname))
+		return;
+
+	PrefetchName = mapname;
+	GameMap::Prefetch(mapname);
+}
+
+/*
+======================
+=
+= CA_UpdatePrefetch
+=
+= Builds the map queued by CA_PrefetchMap and warms the texture cache for
+= it. Loading a map touches some level globals, so those are put back and
+= applied by CA_CacheMap if the map is used.
+=
+======================
+*/
+
+void CA_UpdatePrefetch ()
+{
+	if(PrefetchName.IsEmpty())
+		return;
+
+	PrefetchedName = PrefetchName;
+	PrefetchName = FString();
+
+	LevelInfo *const oldLevelInfo = levelInfo;
+	const short oldSecretTotal = gamestate.secrettotal;
+	const fixed oldVisibility = gLevelVisibility;
+	const fixed oldMaxLightVis = gLevelMaxLightVis;
+	const int oldLight = gLevelLight;
+
+	levelInfo = &LevelInfo::Find(PrefetchedName);
+	gamestate.secrettotal = 0;
+	try
+	{
+		PrefetchedMap = new GameMap(PrefetchedName);
+		PrefetchedMap->LoadMap(false);
+		TexMan.PrecacheLevel(PrefetchedMap, false);
+	}
+	catch(CRecoverableError &)
+	{
+		// Let the error be reported when the map is actually loaded.
+		PrefetchedMap.Reset();
+	}
+
+	PrefetchedState.secrettotal = gamestate.secrettotal;
+	PrefetchedState.visibility = gLevelVisibility;
+	PrefetchedState.maxLightVis = gLevelMaxLightVis;
+	PrefetchedState.light = gLevelLight;
+
+	levelInfo = oldLevelInfo;
+	gamestate.secrettotal = oldSecretTotal;
+	gLevelVisibility = oldVisibility;
+	gLevelMaxLightVis = oldMaxLightVis;
+	gLevelLight = oldLight;
+}
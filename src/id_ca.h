@@ -9,6 +9,9 @@ extern	class LevelInfo *levelInfo;
 //===========================================================================
 
 void CA_CacheMap (const class FString &mapname, bool loading);
+void CA_PrefetchMap (const class FString &mapname);
+void CA_ClearPrefetch ();
+void CA_UpdatePrefetch ();
 
 void CA_CacheScreen (class FTexture *tex, bool noaspect=false);
 
@@ -40,6 +40,8 @@
 #include "wl_main.h"
 #include "wl_net.h"
 #include "id_sd.h"
+#include "id_sd_mix.h"
+#include "m_crc32.h"
 
 // Introduced in SDL_mixer 2.0.2
 #ifndef SDL_MIXER_VERSION_ATLEAST
@@ -61,7 +63,7 @@
 // Mutex for thread-safe audio:
 SDL_mutex *audioMutex;
 
-globalsoundpos channelSoundPos[MIX_CHANNELS];
+globalsoundpos channelSoundPos[DigiMixer::MAX_VOICES];
 globalsoundpos AdlibSoundPos;
 
 //      Global variables
@@ -113,7 +115,7 @@ static  Instrument              alZeroInst;
 static  volatile bool			sqActive;
 static  word                   *sqHack;
 static	TUniquePtr<word[]>		sqHackFreeable;
-static  word                   *sqHackPtr;
+static  const word             *sqHackPtr;
 static  int                     sqHackLen;
 static  int                     sqHackSeqLen;
 static  longword                sqHackTime;
@@ -496,7 +498,7 @@ void SD_StopDigitized(void)
 	if ((DigiMode == sds_PC) && (SoundMode == sdm_PC))
 		SDL_SoundFinished();
 
-	Mix_HaltChannel(-1);
+	DigiMixer::Stop();
 }
 
 void SD_SetPosition(int channel, int leftpos, int rightpos)
@@ -512,7 +514,7 @@ void SD_SetPosition(int channel, int leftpos, int rightpos)
 			default:
 				break;
 			case sds_SoundBlaster:
-				Mix_SetPanning(channel, TO_SDL_POSITION(leftpos), TO_SDL_POSITION(rightpos));
+				DigiMixer::SetPanning(channel, TO_SDL_POSITION(leftpos), TO_SDL_POSITION(rightpos));
 				break;
 		}
 	}
@@ -524,96 +526,34 @@ void SD_SetPosition(int channel, int leftpos, int rightpos)
 	}
 }
 
-// Mac format sound loading.
-struct MacSoundData
+// Converts decoded audio to the mono 16-bit format used by the mixer. The
+// rate is kept since voices are resampled as they're mixed.
+static FDigiSample *SDL_ConvertDigiSample(const Uint8 *data, Uint32 length, Uint16 format, int channels, int rate)
 {
-	uint8_t *data;
-	Sint64 pos;
-	int size;
-};
-static Sint64 MacSound_Size(SDL_RWops *ops)
-{
-	return (Sint64)((MacSoundData*)ops->hidden.unknown.data1)->size;
-}
-#if SDL_VERSION_ATLEAST(2,0,0)
-static Sint64 MacSound_Seek(SDL_RWops *ops, Sint64 pos, int relative)
-#else
-static int MacSound_Seek(SDL_RWops *ops, int pos, int relative)
-#endif
-{
-	Sint64 &curpos = ((MacSoundData*)ops->hidden.unknown.data1)->pos;
-	switch(relative)
+	SDL_AudioCVT cvt;
+	if(SDL_BuildAudioCVT(&cvt, format, channels, rate, AUDIO_S16SYS, 1, rate) < 0)
 	{
-		case RW_SEEK_SET:
-			curpos = pos;
-			break;
-		case RW_SEEK_CUR:
-			curpos += pos;
-			break;
-		case RW_SEEK_END:
-			curpos = ((MacSoundData*)ops->hidden.unknown.data1)->size+pos;
-			break;
+		printf("Unable to convert sound: %s\n", SDL_GetError());
+		return NULL;
 	}
-	return (int)curpos;
-}
-#if SDL_VERSION_ATLEAST(2,0,0)
-static size_t MacSound_Read(SDL_RWops *ops, void *buffer, size_t size, size_t nmem)
-#else
-static int MacSound_Read(SDL_RWops *ops, void *buffer, int size, int nmem)
-#endif
-{
-	static const char WAV_HEADER[40] = {
-		'R','I','F','F',0,0,0,0,'W','A','V','E',
-		'f','m','t',' ',16,0,0,0,1,0,1,0,
-		0x22,0x56,0,0,0x22,0x56,0,0,1,0,8,0,
-		'd','a','t','a'
-	};
-	static const unsigned int MacSoundHeaderSize = 0x2A;
 
-	size_t totalsize = size*nmem;
-	DWORD ssize = (DWORD)(MacSound_Size(ops)-MacSoundHeaderSize);
-	Sint64 &pos = ((MacSoundData*)ops->hidden.unknown.data1)->pos;
-	if(pos < (Sint64)sizeof(WAV_HEADER))
-	{
-		size_t copysize = MIN<size_t>(totalsize, static_cast<size_t>(sizeof(WAV_HEADER)-pos));
-		memcpy(buffer, WAV_HEADER+pos, copysize);
-		pos += copysize;
-		buffer = ((char*)buffer)+copysize;
-		totalsize -= copysize;
-		if(totalsize == 0)
-			return nmem;
-	}
-	if(pos < (Sint64)sizeof(WAV_HEADER)+4)
+	FDigiSample *sample = new FDigiSample;
+	sample->Rate = rate;
+	sample->Data.Resize((length*MAX(cvt.len_mult, 1)+1)/2);
+	memcpy(&sample->Data[0], data, length);
+	if(cvt.needed)
 	{
-		DWORD leSize = LittleLong(ssize);
-
-		size_t copysize = MIN<size_t>(totalsize, static_cast<size_t>(sizeof(leSize)+sizeof(WAV_HEADER)-pos));
-		memcpy(buffer, (char*)(&leSize)+(pos-sizeof(WAV_HEADER)), copysize);
-		pos += copysize;
-		buffer = ((char*)buffer)+copysize;
-		totalsize -= copysize;
-		if(totalsize == 0)
-			return nmem;
+		cvt.buf = (Uint8*)&sample->Data[0];
+		cvt.len = length;
+		SDL_ConvertAudio(&cvt);
+		length = cvt.len_cvt;
 	}
-
-	size_t copysize = MIN<size_t>(totalsize, static_cast<size_t>(ssize-(pos-sizeof(WAV_HEADER)-4)));
-	memcpy(buffer, ((MacSoundData*)ops->hidden.unknown.data1)->data+pos-sizeof(WAV_HEADER)-4, copysize);
-
-	// Mac sound data is signed, we need unsigned
-	unsigned char* pcm = (unsigned char*)buffer;
-	for(size_t i = copysize;i-- > 0;)
-		*pcm++ += 0x80;
-
-	return (int)(copysize/size);
-}
-static int MacSound_Close(SDL_RWops *ops)
-{
-	free(((MacSoundData*)ops->hidden.unknown.data1)->data);
-	free(ops->hidden.unknown.data1);
-	return 0;
+	sample->Data.Resize(length/2);
+	sample->Data.ShrinkToFit();
+	return sample;
 }
 
-Mix_Chunk* SD_PrepareSound(int which)
+FDigiSample* SD_PrepareSound(int which)
 {
 	int size = Wads.LumpLength(which);
 	if(size == 0)
@@ -628,28 +568,40 @@ Mix_Chunk* SD_PrepareSound(int which)
 	// 8-bit or 16-bit, but it looks like the sample rate is coded to ~22050.
 	if(size > 0x2A && BigShort(*(WORD*)soundData) == 1)
 	{
-		SDL_RWops *ops = SDL_AllocRW();
-		//ops->size = MacSound_Size;
-		ops->seek = MacSound_Seek;
-		ops->read = MacSound_Read;
-		ops->write = NULL;
-		ops->close = MacSound_Close;
-		ops->type = 0;
-
-		MacSoundData *macSndData = (MacSoundData*)malloc(sizeof(MacSoundData));
-		ops->hidden.unknown.data1 = macSndData;
-
-		macSndData->data = (uint8_t*)malloc(size-0x2A);
-		macSndData->size = size-0x2A;
-		macSndData->pos = 0;
-		memcpy(macSndData->data, soundData+0x2A, size-0x2A);
+		// Mac sound data is signed 8-bit
+		FDigiSample *sample = new FDigiSample;
+		sample->Rate = 22050;
+		sample->Data.Resize(size-0x2A);
 		for(unsigned int i = size-0x2A;i-- > 0;)
-			macSndData->data[i] = 0x80+macSndData->data[i];
+			sample->Data[i] = (SWORD)(((signed char)soundData[0x2A+i])<<8);
+		return sample;
+	}
+
+	// Most sounds are WAV and can be used at their own rate, anything else
+	// needs SDL_mixer's decoders which convert to the output format.
+	SDL_RWops *ops = SDL_RWFromMem(soundData, size);
+	FDigiSample *sample = NULL;
 
-		return Mix_LoadWAV_RW(ops, 1);
+	SDL_AudioSpec spec;
+	Uint8 *wavData;
+	Uint32 wavLength;
+	if(SDL_LoadWAV_RW(ops, 0, &spec, &wavData, &wavLength))
+	{
+		sample = SDL_ConvertDigiSample(wavData, wavLength, spec.format, spec.channels, spec.freq);
+		SDL_FreeWAV(wavData);
 	}
+	else
+	{
+		SDL_RWseek(ops, 0, RW_SEEK_SET);
+		if(Mix_Chunk *chunk = Mix_LoadWAV_RW(ops, 0))
+		{
+			sample = SDL_ConvertDigiSample(chunk->abuf, chunk->alen, AudioSpec.format, AudioSpec.channels, AudioSpec.frequency);
+			Mix_FreeChunk(chunk);
+		}
+	}
+	SDL_RWclose(ops);
 
-	return Mix_LoadWAV_RW(SDL_RWFromMem(soundData, size), 1);
+	return sample;
 }
 
 static int SD_PlayDigitized(const SoundData &which,int leftpos,int rightpos,SoundChannel chan)
@@ -665,28 +617,23 @@ static int SD_PlayDigitized(const SoundData &which,int leftpos,int rightpos,Soun
 
 	SoundInfo.SetLastPlayTick(which, currentTick);
 
-	int channel = chan;
-	if(chan == SD_GENERIC)
-	{
-		channel = Mix_GroupAvailable(1);
-		if(channel == -1) channel = Mix_GroupOldest(1);
-		if(channel == -1)           // All sounds stopped in the meantime?
-			channel = Mix_GroupAvailable(1);
-	}
-	SD_SetPosition(channel, leftpos,rightpos);
+	if((leftpos < 0) || (leftpos > 15) || (rightpos < 0) || (rightpos > 15)
+			|| ((leftpos == 15) && (rightpos == 15)))
+		I_FatalError("SD_PlayDigitized: Illegal position");
 
 	DigiPlaying = true;
 
-	Mix_Chunk *sample = which.GetDigitalData();
+	FDigiSample *sample = which.GetDigitalData();
 	if(sample == NULL)
 		return 0;
 
-	Mix_Volume(channel, static_cast<int> (ceil(128.0*MULTIPLY_VOLUME(SoundVolume))));
-	if(Mix_PlayChannel(channel, sample, 0) == -1)
-	{
-		printf("Unable to play sound: %s\n", Mix_GetError());
+	// Generic sounds get a voice from the mixer, which may steal one from a
+	// less important sound or drop this one if every voice is busy.
+	const int channel = DigiMixer::Play(sample, chan, which.GetPriority(),
+		TO_SDL_POSITION(leftpos), TO_SDL_POSITION(rightpos),
+		static_cast<int> (ceil(256.0*MULTIPLY_VOLUME(SoundVolume))));
+	if(channel == -1)
 		return 0;
-	}
 
 	// Return channel + 1 because zero is a valid channel.
 	return channel + 1;
@@ -909,6 +856,276 @@ gloabal variables that need to be accessed in SDL_IMFMusicPlayer().
 //byte *curAlSoundPtr = 0;
 //longword curAlLengthLeft = 0;
 
+/*
+=============================================================================
+
+                     IMF PRE-RENDERING
+
+-----------------------------------------------------------------------------
+
+IMF music always sounds the same for a given sample rate, so instead of
+running it through the OPL emulator every time it can be rendered once into
+memory and streamed from there. The first time a song is played it is
+rendered on a background thread while it plays live. The next time it
+starts the cached copy is used.
+
+The sequencer keeps running when a cached copy is used, it just doesn't
+write to the OPL. That keeps SD_MusicOff() offsets and looping the same
+since the cached song is one pass of the sequencer at one tick of samples
+per tick.
+
+The cache is limited by MusicPrerenderMemory (KiB), 0 disables it.
+
+=============================================================================
+*/
+
+unsigned int MusicPrerenderMemory = 0;
+
+#ifdef USE_GPL
+struct PrerenderedMusic
+{
+	DWORD CRC;
+	int Rate;
+	TArray<Bit32s> Samples;	// Mono, raw chip output at full volume
+	SDL_atomic_t Ready;	// 1 when rendered, -1 if it couldn't be
+};
+
+static TArray<PrerenderedMusic *> prerenderCache;
+static PrerenderedMusic *sqCached = NULL;	// Protected by audioMutex
+static unsigned int sqCachedPos;
+
+static SDL_Thread *prerenderThread = NULL;
+static SDL_atomic_t prerenderAbort;
+static PrerenderedMusic *prerenderSong;
+static TUniquePtr<word[]> prerenderData;
+static int prerenderLen;
+
+struct PrerenderOPL
+{
+	DBOPL::Chip &chip;
+	const int volume;
+
+	PrerenderOPL(DBOPL::Chip &chip, int volume) : chip(chip), volume(volume) {}
+	void Write(byte reg, byte val) { YM3812Write(chip, reg, val, volume); }
+};
+
+static int SDL_PrerenderIMF(void *)
+{
+	static const int volume = MAX_VOLUME;
+
+	DBOPL::Chip chip;
+	chip.Setup(AudioSpec.frequency);
+	for(int i=1;i<0xf6;i++)
+		YM3812Write(chip,i,0,volume);
+	YM3812Write(chip,1,0x20,volume);
+
+	const size_t limit = (size_t)MusicPrerenderMemory*1024/sizeof(Bit32s);
+	TArray<Bit32s> samples;
+	Bit32s buffer[512];
+
+	PrerenderOPL opl(chip, volume);
+	const word *ptr = prerenderData.Get();
+	int len = prerenderLen;
+	longword time = 0, tick = 0;
+	while(len > 0)
+	{
+		if(SDL_AtomicGet(&prerenderAbort) || samples.Size() + samplesPerMusicTick > limit)
+		{
+			SDL_AtomicSet(&prerenderSong->Ready, -1);
+			return 0;
+		}
+
+		SD_IMFStep(ptr, len, time, tick, opl);
+		++tick;
+
+		const unsigned int start = samples.Reserve(samplesPerMusicTick);
+		for(int done = 0;done < samplesPerMusicTick;)
+		{
+			const int count = MIN(samplesPerMusicTick - done, 512);
+			// Volume is applied when mixing, so keep the output unclamped
+			chip.GenerateBlock2(count, buffer);
+			memcpy(&samples[start+done], buffer, count*sizeof(Bit32s));
+			done += count;
+		}
+	}
+
+	prerenderSong->Samples = samples;
+	SDL_AtomicSet(&prerenderSong->Ready, 1);
+	return 0;
+}
+
+static void SDL_FinishPrerender(bool abort)
+{
+	if(prerenderThread)
+	{
+		if(abort)
+			SDL_AtomicSet(&prerenderAbort, 1);
+		SDL_WaitThread(prerenderThread, NULL);
+		prerenderThread = NULL;
+		prerenderData.Reset();
+	}
+}
+
+// Drops songs which couldn't be rendered and then finished songs, oldest
+// first, until there's room for another one. Must not be called while a song
+// is being rendered.
+static void SDL_TrimPrerenderCache(size_t needed)
+{
+	size_t total = needed;
+	for(unsigned int i = 0;i < prerenderCache.Size();)
+	{
+		PrerenderedMusic *song = prerenderCache[i];
+		if(SDL_AtomicGet(&song->Ready) < 0)
+		{
+			if(song == prerenderSong)
+				prerenderSong = NULL;
+			delete song;
+			prerenderCache.Delete(i);
+			continue;
+		}
+
+		total += song->Samples.Size()*sizeof(Bit32s);
+		++i;
+	}
+
+	for(unsigned int i = 0;i < prerenderCache.Size() && total > (size_t)MusicPrerenderMemory*1024;)
+	{
+		PrerenderedMusic *song = prerenderCache[i];
+		if(song == sqCached || song == prerenderSong || song->Samples.Size() == 0)
+		{
+			++i;
+			continue;
+		}
+
+		total -= song->Samples.Size()*sizeof(Bit32s);
+		delete song;
+		prerenderCache.Delete(i);
+	}
+}
+
+// Returns the cached copy of the given IMF data if there is one, otherwise
+// starts rendering it.
+static PrerenderedMusic *SDL_FindPrerenderedMusic(const word *data, int len)
+{
+	if(MusicPrerenderMemory == 0)
+		return NULL;
+
+	const DWORD crc = CalcCRC32((const BYTE *)data, len);
+	for(unsigned int i = 0;i < prerenderCache.Size();++i)
+	{
+		PrerenderedMusic *song = prerenderCache[i];
+		if(song->CRC == crc && song->Rate == AudioSpec.frequency)
+		{
+			// Most recently used songs are kept at the end
+			prerenderCache.Delete(i);
+			prerenderCache.Push(song);
+			return SDL_AtomicGet(&song->Ready) > 0 && song->Samples.Size() ? song : NULL;
+		}
+	}
+
+	if(prerenderThread)
+	{
+		// Only render one song at a time.
+		if(SDL_AtomicGet(&prerenderSong->Ready) == 0)
+			return NULL;
+		SDL_FinishPrerender(false);
+	}
+	SDL_TrimPrerenderCache(0);
+
+	prerenderSong = new PrerenderedMusic;
+	prerenderSong->CRC = crc;
+	prerenderSong->Rate = AudioSpec.frequency;
+	SDL_AtomicSet(&prerenderSong->Ready, 0);
+	prerenderCache.Push(prerenderSong);
+
+	prerenderData.Reset(new word[(len+1)/2]);
+	memcpy(prerenderData.Get(), data, len);
+	prerenderLen = len;
+	SDL_AtomicSet(&prerenderAbort, 0);
+	if(!(prerenderThread = SDL_CreateThread(SDL_PrerenderIMF, "IMFPrerender", NULL)))
+	{
+		// Rendering here would stall the game for the length of the song,
+		// just keep playing through the emulator. This is always the case
+		// on web builds without pthreads.
+		SDL_AtomicSet(&prerenderSong->Ready, -1);
+		prerenderData.Reset();
+	}
+	return NULL;
+}
+
+// Mixes the cached song into the emulator output. Returns false if there is
+// nothing cached playing.
+static bool SDL_MixPrerenderedMusic(Sint16 *stream16, int length)
+{
+	if(!sqCached)
+		return false;
+
+	SDL_LockMutex(audioMutex);
+	if(!sqCached || !sqActive)
+	{
+		const bool cached = sqCached != NULL;
+		SDL_UnlockMutex(audioMutex);
+		return cached;
+	}
+
+	// Scale before clamping like the emulator does for each channel
+	const double volume = MULTIPLY_VOLUME(MusicVolume);
+	const Bit32s *samples = &sqCached->Samples[0];
+	const unsigned int size = sqCached->Samples.Size();
+	while(length--)
+	{
+		// Multiply by 4 to match YM3812UpdateOne
+		const Bit32s sample = clamp<Bit32s>((Bit32s)(samples[sqCachedPos]*volume) << 2, -32768, 32767);
+		stream16[0] = (Sint16)clamp<Bit32s>(stream16[0] + sample, -32768, 32767);
+		stream16[1] = (Sint16)clamp<Bit32s>(stream16[1] + sample, -32768, 32767);
+		stream16 += 2;
+
+		if(++sqCachedPos >= size)
+			sqCachedPos = 0;
+	}
+	SDL_UnlockMutex(audioMutex);
+	return true;
+}
+
+// Switches to the cached copy of the IMF song which is about to start, if
+// there is one. ticks is the sequencer tick that the song resumes from.
+static void SDL_UsePrerenderedMusic(const word *data, int len, longword ticks)
+{
+	PrerenderedMusic *song = data ? SDL_FindPrerenderedMusic(data, len) : NULL;
+
+	SDL_LockMutex(audioMutex);
+	sqCached = song;
+	if(song)
+		sqCachedPos = (ticks*samplesPerMusicTick) % song->Samples.Size();
+	SDL_UnlockMutex(audioMutex);
+}
+
+static void SDL_ShutPrerender()
+{
+	SDL_FinishPrerender(true);
+	sqCached = NULL;
+	for(unsigned int i = 0;i < prerenderCache.Size();++i)
+		delete prerenderCache[i];
+	prerenderCache.Clear();
+	prerenderSong = NULL;
+}
+#else
+static const void *sqCached = NULL;
+static inline bool SDL_MixPrerenderedMusic(Sint16 *, int) { return false; }
+static inline void SDL_UsePrerenderedMusic(const word *, int, longword) {}
+static inline void SDL_ShutPrerender() {}
+#endif
+
+// Music goes to the live chip unless the song is being played prerendered.
+struct MusicOPL
+{
+	void Write(byte reg, byte val)
+	{
+		if(!sqCached)
+			alOutMusic(reg, val);
+	}
+};
+
 static int numreadysamples = 0;
 static int soundTimeCounter = SOUND_TICKS;
 static void SDL_IMFMusicPlayer(void *udata, Uint8 *stream, int sampleslen)
@@ -923,6 +1140,7 @@ static void SDL_IMFMusicPlayer(void *udata, Uint8 *stream, int sampleslen)
 			{
 				if(MusicMode != smm_Off || SoundMode == sdm_AdLib)
 					YM3812UpdateOne(oplChip, stream16, numreadysamples);
+				SDL_MixPrerenderedMusic(stream16, numreadysamples);
 
 				// Mix the emulated PC sounds into the AdLib buffer:
 				SDL_PCEmulateAndMix(stream16, numreadysamples);
@@ -934,6 +1152,7 @@ static void SDL_IMFMusicPlayer(void *udata, Uint8 *stream, int sampleslen)
 			{
 				if(MusicMode != smm_Off || SoundMode == sdm_AdLib)
 					YM3812UpdateOne(oplChip, stream16, sampleslen);
+				SDL_MixPrerenderedMusic(stream16, sampleslen);
 
 				// Mix the emulated PC sounds into the AdLib buffer:
 				SDL_PCEmulateAndMix(stream16, sampleslen);
@@ -975,15 +1194,8 @@ static void SDL_IMFMusicPlayer(void *udata, Uint8 *stream, int sampleslen)
 			MIDI_IRQService();
 		else if (sqActive)
 		{
-			do
-			{
-				if(sqHackTime > alTimeCount) break;
-				sqHackTime = alTimeCount + LittleShort(*(sqHackPtr+1));
-				alOutMusic(*(byte *) sqHackPtr, *(((byte *) sqHackPtr)+1));
-				sqHackPtr += 2;
-				sqHackLen -= 4;
-			}
-			while(sqHackLen>0);
+			MusicOPL opl;
+			SD_IMFStep(sqHackPtr, sqHackLen, sqHackTime, alTimeCount, opl);
 			alTimeCount++;
 			if(!sqHackLen)
 			{
@@ -1000,9 +1212,134 @@ static void SDL_IMFMusicPlayer(void *udata, Uint8 *stream, int sampleslen)
 	}
 }
 
-static void SDL_MixEmulators(void *udata, Uint8 *mixed_stream, int len)
+/*
+=============================================================================
+
+                     EMULATOR RENDER-AHEAD
+
+-----------------------------------------------------------------------------
+
+The sequencers and the OPL emulator are run on their own thread which stays
+slightly ahead of the mixer by rendering into a ring buffer. The mixer
+callback then only has to copy the samples out, so it never has to wait on
+'audioMutex' while the game thread starts sounds or music, nor run the OPL
+emulator on a tight deadline with small audio buffers.
+
+Since the callback takes a whole audio buffer at once the ring has to be a
+buffer and a sound tick ahead, which delays anything rendered into it by that
+much. Digitized sounds are mixed into the ring along with the emulators so
+that the two stay in step with each other.
+
+The ring is only ever written by the synth thread and read by the mixer
+callback so the two positions are all the synchronization needed. If no
+thread can be created the emulators are run from the callback as before.
+
+=============================================================================
+*/
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define USE_SYNTH_THREAD
+#endif
+
+static SDL_Thread *synthThread = NULL;
+static SDL_sem *synthSpace = NULL;	// Posted whenever the mixer frees up space
+static SDL_atomic_t synthQuit;
+static SDL_atomic_t synthReadPos, synthWritePos;	// In sample frames
+static TUniquePtr<Sint16[]> synthRing;
+static unsigned int synthRingMask;
+static unsigned int synthChunk;	// Frames rendered at once
+static unsigned int synthAhead;	// Frames to keep buffered
+
+static int SDL_SynthThread(void *)
 {
-	if(MusicMode == smm_Off && !(SoundMode == sdm_AdLib || SoundMode == sdm_PC))
+	TUniquePtr<Sint16[]> chunk(new Sint16[synthChunk*2]);
+
+	while(!SDL_AtomicGet(&synthQuit))
+	{
+		const unsigned int writePos = SDL_AtomicGet(&synthWritePos);
+		if(writePos - (unsigned int)SDL_AtomicGet(&synthReadPos) + synthChunk > synthAhead)
+		{
+			SDL_SemWaitTimeout(synthSpace, 100);
+			continue;
+		}
+
+		memset(chunk.Get(), 0, synthChunk*4);
+		SDL_IMFMusicPlayer(NULL, (Uint8 *)chunk.Get(), synthChunk);
+		DigiMixer::Mix(chunk.Get(), synthChunk);
+
+		const unsigned int start = writePos & synthRingMask;
+		const unsigned int first = MIN(synthChunk, synthRingMask + 1 - start);
+		memcpy(&synthRing[start*2], chunk.Get(), first*4);
+		memcpy(&synthRing[0], chunk.Get() + first*2, (synthChunk - first)*4);
+		SDL_AtomicAdd(&synthWritePos, synthChunk);
+	}
+	return 0;
+}
+
+// Copies up to sampleslen frames of rendered audio. Anything the synth thread
+// didn't get to in time is left silent.
+static void SDL_ReadSynthRing(Sint16 *stream16, int sampleslen)
+{
+	const unsigned int readPos = SDL_AtomicGet(&synthReadPos);
+	const unsigned int count = MIN<unsigned int>(sampleslen, SDL_AtomicGet(&synthWritePos) - readPos);
+
+	const unsigned int start = readPos & synthRingMask;
+	const unsigned int first = MIN(count, synthRingMask + 1 - start);
+	memcpy(stream16, &synthRing[start*2], first*4);
+	memcpy(stream16 + first*2, &synthRing[0], (count - first)*4);
+
+	SDL_AtomicAdd(&synthReadPos, count);
+	SDL_SemPost(synthSpace);
+}
+
+static void SDL_StartSynthThread()
+{
+#ifdef USE_SYNTH_THREAD
+	// Render a sound effect tick at a time. The callback reads a full audio
+	// buffer so that much needs to be ready, plus the chunk in progress.
+	synthChunk = samplesPerMusicTick*SOUND_TICKS;
+	synthAhead = param_audiobuffer + synthChunk;
+
+	unsigned int ringSize = 1;
+	while(ringSize < synthAhead)
+		ringSize <<= 1;
+	synthRing.Reset(new Sint16[ringSize*2]);
+	synthRingMask = ringSize - 1;
+
+	SDL_AtomicSet(&synthQuit, 0);
+	SDL_AtomicSet(&synthReadPos, 0);
+	SDL_AtomicSet(&synthWritePos, 0);
+	if((synthSpace = SDL_CreateSemaphore(0)) == NULL)
+		return;
+
+	if(!(synthThread = SDL_CreateThread(SDL_SynthThread, "AudioSynth", NULL)))
+	{
+		SDL_DestroySemaphore(synthSpace);
+		synthSpace = NULL;
+	}
+#endif
+}
+
+static void SDL_StopSynthThread()
+{
+	if(synthThread)
+	{
+		SDL_AtomicSet(&synthQuit, 1);
+		SDL_SemPost(synthSpace);
+		SDL_WaitThread(synthThread, NULL);
+		synthThread = NULL;
+
+		SDL_DestroySemaphore(synthSpace);
+		synthSpace = NULL;
+	}
+}
+
+// Everything the engine plays itself is mixed here at 16-bit stereo and then
+// converted to the output format in one pass.
+static void SDL_MixEngine(void *udata, Uint8 *mixed_stream, int len)
+{
+	const bool emulators = MusicMode != smm_Off || SoundMode == sdm_AdLib || SoundMode == sdm_PC;
+	if(!emulators && !DigiMixer::IsPlaying())
 		return;
 
 	const int sampleslen = (len/AudioSpec.channels)>>1;
@@ -1022,7 +1359,14 @@ static void SDL_MixEmulators(void *udata, Uint8 *mixed_stream, int len)
 	}
 
 	memset(stream, 0, len);
-	SDL_IMFMusicPlayer(udata, stream, sampleslen);
+	if(synthThread)
+		SDL_ReadSynthRing((Sint16 *)(void *)stream, sampleslen);
+	else
+	{
+		if(emulators)
+			SDL_IMFMusicPlayer(udata, stream, sampleslen);
+		DigiMixer::Mix((Sint16 *)(void *)stream, sampleslen);
+	}
 
 	if(AudioCVTStereo.needed)
 	{
@@ -1071,8 +1415,9 @@ SDL_StartSB()
 		printf("S_Init: Failed to build stereo audio conversion: %s\n", SDL_GetError());
 	}
 
-	Mix_ReserveChannels(2);  // reserve player and boss weapon channels
-	Mix_GroupChannels(2, MIX_CHANNELS-1, 1); // group remaining channels
+	// Digitized sounds are mixed by the engine, see id_sd_mix.cpp
+	Mix_AllocateChannels(0);
+	DigiMixer::Init(AudioSpec.frequency, param_audiobuffer, SD_ChannelFinished);
 
 	// Init music
 	if(YM3812Init(1,3579545,AudioSpec.frequency))
@@ -1086,8 +1431,8 @@ SDL_StartSB()
 	YM3812Write(oplChip,1,0x20,MAX_VOLUME); // Set WSE=1
 
 	samplesPerMusicTick = AudioSpec.frequency / MUSIC_RATE; // SDL_t0FastAsmService played at 700Hz
-	Mix_SetPostMix(SDL_MixEmulators, 0);
-	Mix_ChannelFinished(SD_ChannelFinished);
+	SDL_StartSynthThread();
+	Mix_SetPostMix(SDL_MixEngine, 0);
 
 	Mix_VolumeMusic(static_cast<int> (ceil(128.0*MULTIPLY_VOLUME(MusicVolume))));
 
@@ -1232,6 +1577,11 @@ SD_Shutdown(void)
 	SD_MusicOff();
 	SD_StopSound();
 
+	Mix_SetPostMix(NULL, NULL);
+	DigiMixer::Shutdown();
+	SDL_StopSynthThread();
+	SDL_ShutPrerender();
+
 	if(audioMutex != NULL)
 	{
 		SDL_DestroyMutex(audioMutex);
@@ -1308,6 +1658,9 @@ int SD_PlaySound(const char* sound, SoundChannel chan)
 #endif
 
 			int channel = SD_PlayDigitized(sdata, lp, rp, chan);
+			if(channel == 0)
+				return 0;
+
 			channelSoundPos[channel-1].positioned = ispos;
 			DigiPriority = sdata.GetPriority();
 			SoundPlaying = sindex;
@@ -1462,6 +1815,8 @@ SD_MusicOff(void)
 
 	SDL_UnlockMutex(audioMutex);
 
+	SDL_UsePrerenderedMusic(NULL, 0, 0);
+
 	switch (MusicMode)
 	{
 		default:
@@ -1565,6 +1920,7 @@ SD_StartMusic(const char* chunk)
 
 			SDL_UnlockMutex(audioMutex);
 
+			SDL_UsePrerenderedMusic(sqHack, sqHackSeqLen, 0);
 			SD_MusicOn();
 		}
 		else
@@ -1653,6 +2009,7 @@ SD_ContinueMusic(const char* chunk, int startoffs)
 			// fast forward to correct position
 			// (needed to reconstruct the instruments)
 
+			longword ticks = 0;
 			for(int i = 0; i < startoffs; i += 2)
 			{
 				byte reg = *(byte *)sqHackPtr;
@@ -1661,6 +2018,7 @@ SD_ContinueMusic(const char* chunk, int startoffs)
 				else if(reg == 0xbd) val &= 0xe0;                     // disable drum flags
 
 				alOut(reg,val);
+				ticks += LittleShort(*(sqHackPtr+1));
 				sqHackPtr += 2;
 				sqHackLen -= 4;
 			}
@@ -1669,6 +2027,7 @@ SD_ContinueMusic(const char* chunk, int startoffs)
 
 			SDL_UnlockMutex(audioMutex);
 
+			SDL_UsePrerenderedMusic(sqHack, sqHackSeqLen, ticks);
 			SD_MusicOn();
 		}
 		else
@@ -10,6 +10,7 @@
 
 #include "wl_def.h"
 #include "dobject.h"
+#include "m_swap.h"
 #include "sndinfo.h"
 
 #define alOut(n,b) 		YM3812Write(oplChip, n, b, AdlibVolumePositioned)
@@ -107,6 +108,21 @@ typedef struct
 } MusicGroup;
 #pragma pack(pop)
 
+// Sends the IMF events due by the given music tick to opl.Write(reg, val).
+// This is the one sequencer used by the music service, the prerenderer and
+// --audiobench so they can't disagree on timing.
+template<class OPL>
+static inline void SD_IMFStep(const word *&ptr, int &len, longword &time, longword tick, OPL &opl)
+{
+	while(len > 0 && time <= tick)
+	{
+		time = tick + LittleShort(*(ptr+1));
+		opl.Write(*(const byte *)ptr, *(((const byte *)ptr)+1));
+		ptr += 2;
+		len -= 4;
+	}
+}
+
 struct globalsoundpos
 {
 	TObjPtr<AActor> source;
@@ -124,6 +140,7 @@ extern  SDMode          SoundMode;
 extern  SDSMode         DigiMode;
 extern  SMMode          MusicMode;
 extern  bool            N3DTempoEmulation;
+extern  unsigned int    MusicPrerenderMemory; // In KiB, 0 disables
 static const int MAX_VOLUME = 20;
 static inline double MULTIPLY_VOLUME(const int &v)
 {
@@ -165,7 +182,9 @@ extern  bool	SD_SetMusicMode(SMMode mode);
 extern  bool    SD_SoundPlaying(void);
 
 extern  void    SD_SetDigiDevice(SDSMode);
-extern  struct Mix_Chunk *SD_PrepareSound(int which);
+extern  struct FDigiSample *SD_PrepareSound(int which);
 extern  void    SD_StopDigitized(void);
 
+extern  void    SD_AudioBench(const char *spec, int rate);
+
 #endif
@@ -0,0 +1,483 @@
+/*
+** id_sd_bench.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Renders music and sounds without an audio device so the cost of the OPL
+** emulators and the digitized sound mixer can be measured, and so changes
+** to them can be checked to be bit exact.
+**
+*/
+
+#include "wl_def.h"
+#include "id_sd.h"
+#include "id_sd_mix.h"
+#include "m_crc32.h"
+#include "m_swap.h"
+#include "sndinfo.h"
+#include "w_wad.h"
+#include "zstring.h"
+#include "zdoomsupport.h"
+#include "templates.h"
+
+#if defined(USE_GPL) || defined(AUDIO_BENCH_ALL_OPL)
+#define BENCH_DBOPL
+#include "dosbox/dbopl.h"
+#endif
+#if !defined(USE_GPL) || defined(AUDIO_BENCH_ALL_OPL)
+#define BENCH_MAMEOPL
+#include "mame/fmopl.h"
+#endif
+
+// Same timing as id_sd.cpp
+#define MUSIC_RATE 700
+#define SOUND_TICKS 5
+
+// Each render is repeated until it has taken at least this long so short
+// songs still give a usable rate.
+#define MIN_BENCH_TIME 1.0
+
+static const char * const HASH_FILE = "audiobench.txt";
+
+static double BenchTime()
+{
+#if SDL_VERSION_ATLEAST(2,0,0)
+	return (double)SDL_GetPerformanceCounter()/SDL_GetPerformanceFrequency();
+#else
+	return SDL_GetTicks()/1000.0;
+#endif
+}
+
+class FBenchOPL
+{
+public:
+	virtual ~FBenchOPL() {}
+
+	virtual const char *GetName() const=0;
+	virtual void Generate(SWORD *stream, int length)=0;	// Mono
+	virtual void Write(int reg, int val)=0;
+
+	void Reset()
+	{
+		for(int i=1;i<0xf6;i++)
+			Write(i, 0);
+		Write(1, 0x20); // Set WSE=1
+	}
+
+protected:
+	static const int volume;
+};
+const int FBenchOPL::volume = MAX_VOLUME;
+
+#ifdef BENCH_DBOPL
+class FBenchDBOPL : public FBenchOPL
+{
+public:
+	FBenchDBOPL(int rate) { chip.Setup(rate); Reset(); }
+
+	const char *GetName() const { return "dbopl"; }
+
+	void Generate(SWORD *stream, int length)
+	{
+		Bit32s buffer[512];
+		while(length > 0)
+		{
+			const int count = MIN(length, 512);
+			chip.GenerateBlock2(count, buffer);
+			for(int i = 0;i < count;++i)
+				*stream++ = (SWORD)clamp<Bit32s>(buffer[i] << 2, -32768, 32767);
+			length -= count;
+		}
+	}
+
+	void Write(int reg, int val)
+	{
+		chip.SetVolume(volume);
+		chip.WriteReg(reg, val);
+	}
+
+private:
+	DBOPL::Chip chip;
+};
+#endif
+
+#ifdef BENCH_MAMEOPL
+// The MAME emulator keeps its chips in globals, so only one of these can
+// exist at a time and not while id_sd.cpp is using it.
+class FBenchMAMEOPL : public FBenchOPL
+{
+public:
+	FBenchMAMEOPL(int rate) { YM3812Init(1, 3579545, rate); Reset(); }
+	~FBenchMAMEOPL() { YM3812Shutdown(); }
+
+	const char *GetName() const { return "mame"; }
+
+	void Generate(SWORD *stream, int length)
+	{
+		INT16 buffer[512*2];
+		while(length > 0)
+		{
+			const int count = MIN(length, 512);
+			YM3812UpdateOne(0, buffer, count);
+			for(int i = 0;i < count;++i)
+				*stream++ = LittleShort(buffer[i*2]);
+			length -= count;
+		}
+	}
+
+	void Write(int reg, int val) { YM3812Write(0, reg, val, volume); }
+};
+#endif
+
+struct BenchResult
+{
+	FString Name;
+	unsigned int Samples;	// Frames per pass
+	unsigned int Passes;
+	double Time;
+	DWORD CRC;
+};
+
+// Writes 16-bit little endian samples to a WAV file and returns the CRC of
+// the sample data as written.
+static DWORD WriteBenchWave(const char *filename, const TArray<SWORD> &samples, int channels, int rate)
+{
+	TArray<SWORD> data(samples);
+	for(unsigned int i = 0;i < data.Size();++i)
+		data[i] = LittleShort(data[i]);
+	const DWORD crc = data.Size() ? CalcCRC32((const BYTE *)&data[0], data.Size()*2) : 0;
+
+	FILE *file = fopen(filename, "wb");
+	if(!file)
+	{
+		printf("Could not write %s.\n", filename);
+		return crc;
+	}
+
+	const DWORD dataSize = data.Size()*2;
+	DWORD header[11] = {
+		MAKE_ID('R','I','F','F'), LittleLong(36+dataSize), MAKE_ID('W','A','V','E'),
+		MAKE_ID('f','m','t',' '), LittleLong(16),
+		DWORD(LittleLong(0x00010000*channels + 1)), DWORD(LittleLong(rate)), DWORD(LittleLong(rate*channels*2)),
+		DWORD(LittleLong(0x00100000 + channels*2)),
+		MAKE_ID('d','a','t','a'), LittleLong(dataSize)
+	};
+	fwrite(header, sizeof(header), 1, file);
+	if(dataSize)
+		fwrite(&data[0], dataSize, 1, file);
+	fclose(file);
+	return crc;
+}
+
+// Plays the IMF music and the AdLib sound effects (one after another on the
+// sound effect channel) through the given emulator until both are done.
+static void RenderOPL(FBenchOPL &opl, const word *music, int musicLen, const TArray<const AdLibSound *> &sounds, int rate, TArray<SWORD> &out)
+{
+	static const byte chanOps[OPL_CHANNELS] = {
+		0, 1, 2, 8, 9, 0xA, 0x10, 0x11, 0x12
+	};
+
+	const int samplesPerTick = rate / MUSIC_RATE;
+
+	const word *sqPtr = music;
+	int sqLen = musicLen;
+	longword sqTime = 0, tick = 0;
+
+	unsigned int sound = 0;
+	const byte *alSound = NULL;
+	longword alLengthLeft = 0;
+	byte alBlock = 0;
+
+	out.Clear();
+	while(sqLen > 0 || alSound || sound < sounds.Size())
+	{
+		if(tick % SOUND_TICKS == 0)
+		{
+			if(!alSound && sound < sounds.Size())
+			{
+				const AdLibSound *snd = sounds[sound++];
+				const Instrument *inst = &snd->inst;
+				const byte m = chanOps[0], c = m + 3;
+				opl.Write(m + alChar, inst->mChar);
+				opl.Write(m + alScale, inst->mScale);
+				opl.Write(m + alAttack, inst->mAttack);
+				opl.Write(m + alSus, inst->mSus);
+				opl.Write(m + alWave, inst->mWave);
+				opl.Write(c + alChar, inst->cChar);
+				opl.Write(c + alScale, inst->cScale);
+				opl.Write(c + alAttack, inst->cAttack);
+				opl.Write(c + alSus, inst->cSus);
+				opl.Write(c + alWave, inst->cWave);
+				opl.Write(alFreqL, 0);
+				opl.Write(alFreqH, 0);
+				opl.Write(alFeedCon, 0);
+
+				alSound = snd->data;
+				alLengthLeft = LittleLong(snd->common.length);
+				alBlock = ((snd->block & 7) << 2) | 0x20;
+			}
+
+			if(alSound)
+			{
+				if(*alSound)
+				{
+					opl.Write(alFreqL, *alSound);
+					opl.Write(alFreqH, alBlock);
+				} else opl.Write(alFreqH, 0);
+				alSound++;
+				if(!(--alLengthLeft))
+				{
+					alSound = NULL;
+					opl.Write(alFreqH, 0);
+				}
+			}
+		}
+
+		SD_IMFStep(sqPtr, sqLen, sqTime, tick, opl);
+		++tick;
+
+		opl.Generate(&out[out.Reserve(samplesPerTick)], samplesPerTick);
+	}
+}
+
+// Starts each digitized sound a tenth of a second after the previous one
+// and mixes until they have all finished.
+static void RenderMixer(const TArray<const SoundData *> &sounds, int rate, TArray<SWORD> &out)
+{
+	static const int BLOCK_SIZE = 512;
+
+	DigiMixer::Init(rate, BLOCK_SIZE, NULL);
+
+	out.Clear();
+	unsigned int sound = 0;
+	for(unsigned int frame = 0;sound < sounds.Size() || DigiMixer::IsPlaying();frame += BLOCK_SIZE)
+	{
+		for(;sound < sounds.Size() && sound*(rate/10) <= frame;++sound)
+		{
+			DigiMixer::Play(sounds[sound]->GetDigitalData(), -1,
+				sounds[sound]->GetPriority(), 255, 255, 256);
+		}
+
+		SWORD *block = &out[out.Reserve(BLOCK_SIZE*2)];
+		memset(block, 0, BLOCK_SIZE*2*sizeof(SWORD));
+		DigiMixer::Mix(block, BLOCK_SIZE);
+	}
+
+	DigiMixer::Shutdown();
+}
+
+// Compares the hashes with the ones saved by the last run with the same
+// arguments and then saves the new ones.
+static void CompareBenchHashes(const char *spec, int rate, const TArray<BenchResult> &results)
+{
+	TArray<FString> lines;
+	if(FILE *file = fopen(HASH_FILE, "r"))
+	{
+		char line[1024];
+		while(fgets(line, sizeof(line), file))
+		{
+			FString str(line);
+			str.StripRight();
+			if(str.Len())
+				lines.Push(str);
+		}
+		fclose(file);
+	}
+
+	for(unsigned int i = 0;i < results.Size();++i)
+	{
+		FString key;
+		key.Format("%s %d %s ", results[i].Name.GetChars(), rate, spec);
+
+		FString line;
+		line.Format("%s%08X", key.GetChars(), results[i].CRC);
+
+		unsigned int j;
+		for(j = 0;j < lines.Size();++j)
+		{
+			if(lines[j].IndexOf(key) == 0)
+				break;
+		}
+
+		if(j == lines.Size())
+		{
+			printf("%-8s no previous run to compare with\n", results[i].Name.GetChars());
+			lines.Push(line);
+		}
+		else
+		{
+			if(lines[j].Compare(line) == 0)
+				printf("%-8s identical to the previous run\n", results[i].Name.GetChars());
+			else
+				printf("%-8s DIFFERS from the previous run (was %s)\n", results[i].Name.GetChars(), lines[j].Mid(key.Len()).GetChars());
+			lines[j] = line;
+		}
+	}
+
+	if(FILE *file = fopen(HASH_FILE, "w"))
+	{
+		for(unsigned int i = 0;i < lines.Size();++i)
+			fprintf(file, "%s\n", lines[i].GetChars());
+		fclose(file);
+	}
+}
+
+template<class Render>
+static BenchResult RunBench(const char *name, int channels, int rate, Render &render)
+{
+	BenchResult result;
+	result.Name = name;
+	result.Passes = 0;
+
+	TArray<SWORD> samples;
+	const double start = BenchTime();
+	do
+	{
+		render(samples);
+		if(++result.Passes == 1)
+		{
+			FString filename;
+			filename.Format("audiobench-%s.wav", name);
+			result.CRC = WriteBenchWave(filename, samples, channels, rate);
+			result.Samples = samples.Size()/channels;
+		}
+	}
+	while((result.Time = BenchTime() - start) < MIN_BENCH_TIME && result.Samples);
+
+	printf("%-8s %u samples x %u in %.3fs: %.0f samples/s (%.1fx real time) CRC %08X\n",
+		name, result.Samples, result.Passes, result.Time,
+		result.Samples*result.Passes/result.Time,
+		result.Samples*result.Passes/result.Time/rate, result.CRC);
+	return result;
+}
+
+#ifdef BENCH_DBOPL
+struct DBOPLRender
+{
+	const word *music; int musicLen; const TArray<const AdLibSound *> &sounds; int rate;
+	void operator()(TArray<SWORD> &out) { FBenchDBOPL opl(rate); RenderOPL(opl, music, musicLen, sounds, rate, out); }
+};
+#endif
+#ifdef BENCH_MAMEOPL
+struct MAMEOPLRender
+{
+	const word *music; int musicLen; const TArray<const AdLibSound *> &sounds; int rate;
+	void operator()(TArray<SWORD> &out) { FBenchMAMEOPL opl(rate); RenderOPL(opl, music, musicLen, sounds, rate, out); }
+};
+#endif
+struct MixerRender
+{
+	const TArray<const SoundData *> &sounds; int rate;
+	void operator()(TArray<SWORD> &out) { RenderMixer(sounds, rate, out); }
+};
+
+///////////////////////////////////////////////////////////////////////////
+//
+//      SD_AudioBench() - Renders "music,sound,sound..." with every OPL
+//              emulator in the build and the digitized sound mixer, writes
+//              the results to WAV files and reports how fast each went.
+//              Must be called before SD_Startup().
+//
+///////////////////////////////////////////////////////////////////////////
+void SD_AudioBench(const char *spec, int rate)
+{
+	SoundInfo.Init();
+
+	TArray<FString> names;
+	for(const char *start = spec;;)
+	{
+		const char *end = strchr(start, ',');
+		names.Push(end ? FString(start, end-start) : FString(start));
+		if(!end)
+			break;
+		start = end+1;
+	}
+
+	TUniquePtr<byte[]> musicData;
+	const word *music = NULL;
+	int musicLen = 0;
+	if(names[0].Len())
+	{
+		const int lumpNum = SoundInfo.GetMusicLumpNum(names[0]);
+		if(lumpNum == -1)
+			I_Error("Unknown music '%s'.", names[0].GetChars());
+
+		const int length = Wads.LumpLength(lumpNum);
+		musicData.Reset(new byte[length+1]);
+		FWadLump lump = Wads.OpenLumpNum(lumpNum);
+		lump.Read(musicData.Get(), length);
+
+		if(length >= 4 && (memcmp(musicData.Get(), "MThd", 4) == 0 || memcmp(musicData.Get(), "OggS", 4) == 0 || memcmp(musicData.Get(), "fLaC", 4) == 0))
+			I_Error("Only IMF music can be benchmarked.");
+
+		music = reinterpret_cast<const word*>(musicData.Get());
+		if(*music == 0) musicLen = length;
+		else musicLen = MIN<int>(LittleShort(*music++), length-2);
+	}
+
+	TArray<const AdLibSound *> adlibSounds;
+	TArray<const SoundData *> digiSounds;
+	for(unsigned int i = 1;i < names.Size();++i)
+	{
+		const SoundData &sound = SoundInfo[names[i]];
+		if(sound.IsNull())
+		{
+			printf("Unknown sound '%s'.\n", names[i].GetChars());
+			continue;
+		}
+
+		if(sound.HasType(SoundData::ADLIB))
+			adlibSounds.Push((const AdLibSound *)sound.GetAdLibData());
+		if(sound.HasType(SoundData::DIGITAL) && sound.GetDigitalData())
+			digiSounds.Push(&sound);
+	}
+
+	printf("Rendering at %dHz: %d bytes of music, %u AdLib sounds, %u digitized sounds\n",
+		rate, musicLen, adlibSounds.Size(), digiSounds.Size());
+
+	TArray<BenchResult> results;
+	if(music || adlibSounds.Size())
+	{
+#ifdef BENCH_DBOPL
+		DBOPLRender dbopl = { music, musicLen, adlibSounds, rate };
+		results.Push(RunBench("dbopl", 1, rate, dbopl));
+#endif
+#ifdef BENCH_MAMEOPL
+		MAMEOPLRender mame = { music, musicLen, adlibSounds, rate };
+		results.Push(RunBench("mame", 1, rate, mame));
+#endif
+	}
+	if(digiSounds.Size())
+	{
+		MixerRender mixer = { digiSounds, rate };
+		results.Push(RunBench("mixer", 2, rate, mixer));
+	}
+
+	CompareBenchHashes(spec, rate, results);
+}
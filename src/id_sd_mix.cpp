@@ -0,0 +1,338 @@
+/*
+** id_sd_mix.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+**
+*/
+
+#include "wl_def.h"
+#include "id_sd_mix.h"
+#include "templates.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace DigiMixer {
+
+unsigned int NumVoices = 32;
+
+// Playback state, only touched by the mixer.
+struct Voice
+{
+	const FDigiSample *Sample;	// NULL when free
+	unsigned int Pos;
+	unsigned int Frac;	// 16.16 with Pos
+	unsigned int Step;
+	int Volume;	// 0-256
+	int Ticket;	// Which sound this is, see owners
+};
+
+// What the game thread needs to pick a voice to steal.
+struct VoiceSlot
+{
+	unsigned short Priority;
+	int Loudness;
+	unsigned int Started;
+};
+
+// A voice for the mixer to start. Uses the same scheme as the synth ring in
+// id_sd.cpp: only the game thread writes and only the mixer reads, so the two
+// positions are all the synchronization needed.
+static const unsigned int QUEUE_SIZE = 128;
+static Voice startQueue[QUEUE_SIZE];
+static SDL_atomic_t queueRead, queueWrite;
+
+static Voice voices[MAX_VOICES];
+static VoiceSlot slots[MAX_VOICES];	// Game thread only
+
+// Ticket of the sound the game thread last started on each voice, 0 once the
+// voice is free. The mixer drops any voice whose ticket no longer matches,
+// and whichever side frees a voice calls voiceFinished.
+static SDL_atomic_t owners[MAX_VOICES];
+static SDL_atomic_t panning[MAX_VOICES];	// Left pan | right pan<<8
+static SDL_atomic_t activeVoices;
+static int lastTicket = 0;
+
+static void (*voiceFinished)(int) = NULL;
+static int outputRate = 0;
+static unsigned int playCount = 0;
+static TArray<Sint32> accumulator;	// Sized once so that Mix never allocates
+
+void Init(int rate, int frames, void (*finished)(int voice))
+{
+	NumVoices = clamp<unsigned int>(NumVoices, RESERVED_VOICES+2, MAX_VOICES);
+	outputRate = rate;
+	voiceFinished = finished;
+	memset(voices, 0, sizeof(voices));
+	for(unsigned int i = 0;i < MAX_VOICES;++i)
+		SDL_AtomicSet(&owners[i], 0);
+	SDL_AtomicSet(&activeVoices, 0);
+	SDL_AtomicSet(&queueRead, 0);
+	SDL_AtomicSet(&queueWrite, 0);
+
+	accumulator.Resize(frames*2);
+}
+
+void Shutdown()
+{
+	if(!outputRate)
+		return;
+
+	Stop();
+	outputRate = 0;
+}
+
+bool IsPlaying()
+{
+	return SDL_AtomicGet(&activeVoices) != 0;
+}
+
+static inline int Loudness(int leftpan, int rightpan)
+{
+	return MAX(leftpan, rightpan);
+}
+
+// Orders voices from least to most important to keep: lowest priority,
+// then quietest (farthest away), then oldest.
+static bool IsWeaker(const VoiceSlot &a, const VoiceSlot &b)
+{
+	if(a.Priority != b.Priority)
+		return a.Priority < b.Priority;
+	if(a.Loudness != b.Loudness)
+		return a.Loudness < b.Loudness;
+	return a.Started < b.Started;
+}
+
+// Generic sounds take any free voice past the reserved ones. If all of them
+// are busy the weakest voice is stolen unless the new sound is weaker still,
+// in which case it isn't played.
+static int FindVoice(const VoiceSlot &sound)
+{
+	int weakest = -1;
+	for(unsigned int i = RESERVED_VOICES;i < NumVoices;++i)
+	{
+		if(SDL_AtomicGet(&owners[i]) == 0)
+			return i;
+		if(weakest < 0 || IsWeaker(slots[i], slots[weakest]))
+			weakest = i;
+	}
+
+	if(weakest >= 0 && IsWeaker(sound, slots[weakest]))
+		return -1;
+	return weakest;
+}
+
+// Takes the voice away from whatever sound it was playing. Game thread only.
+static void ReleaseVoice(int voice, int ticket)
+{
+	if(SDL_AtomicSet(&owners[voice], ticket) != 0)
+	{
+		if(!ticket)
+			SDL_AtomicAdd(&activeVoices, -1);
+		if(voiceFinished)
+			voiceFinished(voice);
+	}
+	else if(ticket)
+		SDL_AtomicAdd(&activeVoices, 1);
+}
+
+int Play(const FDigiSample *sample, int voice, unsigned short priority, int leftpan, int rightpan, int volume)
+{
+	if(!outputRate || sample->Data.Size() == 0)
+		return -1;
+
+	// If the mixer has fallen this far behind drop the sound.
+	const unsigned int write = SDL_AtomicGet(&queueWrite);
+	if(write - (unsigned int)SDL_AtomicGet(&queueRead) >= QUEUE_SIZE)
+		return -1;
+
+	VoiceSlot slot;
+	slot.Priority = priority;
+	slot.Loudness = Loudness(leftpan, rightpan);
+	slot.Started = playCount++;
+	if(voice < 0)
+		voice = FindVoice(slot);
+	if(voice < 0)
+		return -1;
+
+	if(++lastTicket == 0)
+		lastTicket = 1;
+
+	Voice &sound = startQueue[write & (QUEUE_SIZE-1)];
+	sound.Sample = sample;
+	sound.Pos = sound.Frac = 0;
+	sound.Step = (unsigned int)(((QWORD)sample->Rate<<16)/outputRate);
+	sound.Volume = volume;
+	sound.Ticket = lastTicket;
+
+	slots[voice] = slot;
+	SDL_AtomicSet(&panning[voice], leftpan|(rightpan<<8));
+	ReleaseVoice(voice, lastTicket);
+	SDL_AtomicAdd(&queueWrite, 1);
+	return voice;
+}
+
+void SetPanning(int voice, int leftpan, int rightpan)
+{
+	slots[voice].Loudness = Loudness(leftpan, rightpan);
+	SDL_AtomicSet(&panning[voice], leftpan|(rightpan<<8));
+}
+
+void Stop(int voice)
+{
+	if(!outputRate)
+		return;
+
+	for(unsigned int i = voice < 0 ? 0 : voice;i < (voice < 0 ? MAX_VOICES : (unsigned int)voice+1);++i)
+		ReleaseVoice(i, 0);
+}
+
+// Called by the mixer when a voice reaches the end of its sound. If the game
+// thread already stopped or replaced it then it has been notified already.
+static void FinishVoice(int voice)
+{
+	if(SDL_AtomicCAS(&owners[voice], voices[voice].Ticket, 0))
+	{
+		SDL_AtomicAdd(&activeVoices, -1);
+		if(voiceFinished)
+			voiceFinished(voice);
+	}
+	voices[voice].Sample = NULL;
+}
+
+// Picks up the voices the game thread started since the last block.
+static void StartQueuedVoices()
+{
+	const unsigned int write = SDL_AtomicGet(&queueWrite);
+	unsigned int read = SDL_AtomicGet(&queueRead);
+	for(;read != write;++read)
+	{
+		const Voice &sound = startQueue[read & (QUEUE_SIZE-1)];
+		for(unsigned int i = 0;i < MAX_VOICES;++i)
+		{
+			if(SDL_AtomicGet(&owners[i]) == sound.Ticket)
+			{
+				voices[i] = sound;
+				break;
+			}
+		}
+	}
+	SDL_AtomicSet(&queueRead, read);
+}
+
+// Resamples a voice with linear interpolation and adds it to the 32-bit
+// stereo accumulator. Returns false once the sound has ended.
+static bool MixVoice(Voice &voice, int pan, Sint32 *out, int frames)
+{
+	const SWORD *data = &voice.Sample->Data[0];
+	const unsigned int length = voice.Sample->Data.Size();
+	const int left = voice.Volume*(pan&0xFF);
+	const int right = voice.Volume*((pan>>8)&0xFF);
+
+	while(frames--)
+	{
+		const int cur = data[voice.Pos];
+		const int next = voice.Pos+1 < length ? data[voice.Pos+1] : 0;
+		const int sample = cur + (((next - cur)*(int)(voice.Frac>>1))>>15);
+		out[0] += (sample*left)>>16;
+		out[1] += (sample*right)>>16;
+		out += 2;
+
+		voice.Frac += voice.Step;
+		voice.Pos += voice.Frac>>16;
+		voice.Frac &= 0xFFFF;
+		if(voice.Pos >= length)
+			return false;
+	}
+	return true;
+}
+
+// Adds the accumulated voices to the stream, saturating to 16-bit.
+static void Accumulate(SWORD *stream, const Sint32 *mixed, int count)
+{
+	int i = 0;
+#if defined(__SSE2__)
+	for(;i + 8 <= count;i += 8)
+	{
+		const __m128i lo = _mm_loadu_si128((const __m128i *)(mixed+i));
+		const __m128i hi = _mm_loadu_si128((const __m128i *)(mixed+i+4));
+		const __m128i cur = _mm_loadu_si128((const __m128i *)(stream+i));
+		_mm_storeu_si128((__m128i *)(stream+i), _mm_adds_epi16(cur, _mm_packs_epi32(lo, hi)));
+	}
+#elif defined(__wasm_simd128__)
+	for(;i + 8 <= count;i += 8)
+	{
+		const v128_t lo = wasm_v128_load(mixed+i);
+		const v128_t hi = wasm_v128_load(mixed+i+4);
+		const v128_t cur = wasm_v128_load(stream+i);
+		wasm_v128_store(stream+i, wasm_i16x8_add_sat(cur, wasm_i16x8_narrow_i32x4(lo, hi)));
+	}
+#endif
+	for(;i < count;++i)
+		stream[i] = (SWORD)clamp<Sint32>(stream[i] + clamp<Sint32>(mixed[i], -32768, 32767), -32768, 32767);
+}
+
+void Mix(SWORD *stream, int frames)
+{
+	if(!IsPlaying())
+		return;
+
+	StartQueuedVoices();
+
+	const int block = accumulator.Size()/2;
+	for(;frames > 0;frames -= block, stream += block*2)
+	{
+		const int count = MIN(frames, block);
+		memset(&accumulator[0], 0, count*2*sizeof(Sint32));
+
+		for(unsigned int i = 0;i < MAX_VOICES;++i)
+		{
+			Voice &voice = voices[i];
+			if(!voice.Sample)
+				continue;
+
+			// Stopped or stolen by the game thread
+			if(SDL_AtomicGet(&owners[i]) != voice.Ticket)
+			{
+				voice.Sample = NULL;
+				continue;
+			}
+
+			if(!MixVoice(voice, SDL_AtomicGet(&panning[i]), &accumulator[0], count))
+				FinishVoice(i);
+		}
+		Accumulate(stream, &accumulator[0], count*2);
+	}
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+** id_sd_mix.h
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Engine side mixer for digitized sounds. Voices are resampled from the
+** rate of their sound and mixed along with the emulated AdLib and PC speaker,
+** either on the synth thread or in the SDL_mixer post mix callback.
+**
+** Play, SetPanning and Stop are called from the game thread and Mix from
+** whichever of those renders the emulators. The two never wait on each other: new voices are handed to
+** the mixer through a single producer, single consumer queue, and stopping or
+** replacing a voice only changes which sound the voice belongs to.
+**
+*/
+
+#ifndef __ID_SD_MIX_H__
+#define __ID_SD_MIX_H__
+
+#include "tarray.h"
+
+// Decoded digitized sound, always mono.
+struct FDigiSample
+{
+	TArray<SWORD> Data;
+	int Rate;
+};
+
+namespace DigiMixer {
+
+static const unsigned int RESERVED_VOICES = 2;	// SD_WEAPONS and SD_BOSSWEAPONS
+static const unsigned int MAX_VOICES = 64;
+extern unsigned int NumVoices;	// Including the reserved voices
+
+void	Init(int rate, int frames, void (*finished)(int voice));
+bool	IsPlaying();
+void	Mix(SWORD *stream, int frames);
+int		Play(const FDigiSample *sample, int voice, unsigned short priority, int leftpan, int rightpan, int volume);
+void	SetPanning(int voice, int leftpan, int rightpan);
+void	Shutdown();
+void	Stop(int voice=-1);
+
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "w_wad.h"
 #include "v_font.h"
 #include "v_palette.h"
+#include "v_textrun.h"
 #include "v_video.h"
 #include "r_data/r_translate.h"
 #include "textures/textures.h"
@@ -19,28 +20,21 @@ int	    pa=MENU_CENTER,px,py;
 
 void VWB_DrawPropString(FFont *font, const char* string, EColorRange translation, bool stencil, BYTE stencilcolor)
 {
-	int		    width, height;
-	FTexture	*source;
-	byte	    ch;
-	int cx = px, cy = py;
-
-	height = font->GetHeight();
-	FRemapTable *remap = font->GetColorTranslation(translation);
+	// Same placement as drawing each character with VWB_DrawGraphic, but
+	// the string is only rasterized the first time it's seen.
+	double x = px, y = py, scalex = 1, scaley = 1;
+	if(pa)
+		MenuToRealCoords(x, y, scalex, scaley, (MenuOffset)pa);
+	else
+		screen->VirtualToRealCoords(x, y, scalex, scaley, 320, 200, true, true);
 
-	while ((ch = (byte)*string++)!=0)
-	{
-		if(ch == '\n')
-		{
-			cy += height;
-			cx = px;
-			continue;
-		}
+	FTextRunStyle style(font, translation, scalex, scaley);
+	if(stencil)
+		style.FillColor = GPalette.BaseColors[stencilcolor].d;
 
-		source = font->GetChar(ch, &width);
-		if(source)
-			VWB_DrawGraphic(source, cx, cy, (MenuOffset)pa, remap, stencil, stencilcolor);
-		cx += width;
-	}
+	screen->Lock(false);
+	V_DrawTextRun(screen, style, x, y, string, strlen(string));
+	screen->Unlock();
 }
 
 // Prints a string with word wrapping
@@ -311,6 +305,7 @@ bool FFizzleFader::Update()
 	complete = false;
 
 finished:
+	screen->MarkDirty(x1, y1, x1 + width, y1 + height);
 	byte* vbuf = screen->GetBuffer();
 	for (unsigned y = y1; y < (y1 + height); ++y)
 	{
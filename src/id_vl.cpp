@@ -133,9 +133,6 @@ void	VL_SetVGAPlaneMode (bool forSignon)
 	scaleFactorX = CleanXfac;
 	scaleFactorY = CleanYfac;
 
-	pixelangle = new short[SCREENWIDTH];
-	wallheight = new int[SCREENWIDTH];
-
 	NewViewSize(viewsize);
 
 	screen->Lock(false);
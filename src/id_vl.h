@@ -3,6 +3,8 @@
 #ifndef __ID_VL_H__
 #define __ID_VL_H__
 
+#include "wl_pacer.h"
+
 //===========================================================================
 
 extern  bool	fullscreen;
@@ -20,7 +22,7 @@ extern	bool  screenfaded;
 // VGA hardware routines
 //
 
-#define VL_WaitVBL(a) SDL_Delay((SDL_GetTicks() - TICS2MS(GetTimeCount())) + TICS2MS((a)-1))
+#define VL_WaitVBL(a) Pacer::SleepUntil(Pacer::TicTime(GetTimeCount() + (a)))
 
 void VL_ToggleFullscreen();
 void VL_SetFullscreen(bool isFull);
@@ -151,6 +151,23 @@ class EVDoor : public Thinker
 			return state == Closing || state == Closed;
 		}
 
+		void StorePrevState()
+		{
+			prevamount = amount;
+		}
+
+		void BeginInterpolation(fixed frac)
+		{
+			if(HasPrevState() && amount != prevamount)
+				spot->slideAmount[direction] = spot->slideAmount[direction+2] = prevamount + FixedMul(amount - prevamount, frac);
+		}
+
+		void EndInterpolation()
+		{
+			if(HasPrevState() && amount != prevamount)
+				spot->slideAmount[direction] = spot->slideAmount[direction+2] = amount;
+		}
+
 		void Tick()
 		{
 			if(sndseq)
@@ -183,6 +200,7 @@ class EVDoor : public Thinker
 							ChangeState(Opened);
 					}
 					spot->slideAmount[direction] = spot->slideAmount[direction+2] = amount;
+					spot->UpdateClip();
 					break;
 				case Opened:
 					if(wait == 0)
@@ -212,6 +230,7 @@ class EVDoor : public Thinker
 						map->LinkZones(zone1, zone2, false);
 					}
 					spot->slideAmount[direction] = spot->slideAmount[direction+2] = amount;
+					spot->UpdateClip();
 					break;
 			}
 		}
@@ -327,7 +346,7 @@ class EVDoor : public Thinker
 		FName seqname;
 
 		unsigned int speed;
-		int amount;
+		int amount, prevamount;
 		int opentics;
 		unsigned int wait;
 		bool direction;
@@ -782,6 +801,26 @@ class EVPushwall : public Thinker
 			Super::Destroy();
 		}
 
+		void StorePrevState()
+		{
+			prevspot = spot;
+			prevposition = position;
+		}
+
+		// The pushwall snaps when it moves to the next tile, which is also
+		// when Tick stops setting pushAmount from position.
+		void BeginInterpolation(fixed frac)
+		{
+			if(HasPrevState() && spot == prevspot && position != prevposition)
+				spot->pushAmount = (prevposition + FixedMul(position - prevposition, frac))/16;
+		}
+
+		void EndInterpolation()
+		{
+			if(HasPrevState() && spot == prevspot && position != prevposition)
+				spot->pushAmount = position/16;
+		}
+
 		void Tick()
 		{
 			if(position == 0)
@@ -839,7 +878,10 @@ class EVPushwall : public Thinker
 				moveTo = NULL;
 			}
 			else
+			{
 				spot->pushAmount = position/16;
+				spot->UpdateClip();
+			}
 
 			if(!moveTo)
 			{
@@ -865,13 +907,13 @@ class EVPushwall : public Thinker
 
 	private:
 
-		MapSpot spot, moveTo;
+		MapSpot spot, moveTo, prevspot;
 
 		SndSeqPlayer *sndseq;
 		FName seqname;
 
 		unsigned short	direction;
-		unsigned int	position;
+		unsigned int	position, prevposition;
 		unsigned int	speed;
 		unsigned int	distance;
 		bool nostop;
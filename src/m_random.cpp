@@ -251,15 +251,44 @@ void FRandom::Init(DWORD seed)
 // FRandom :: StaticSumSeeds
 //
 // This function produces a DWORD that can be used to check the consistancy
-// of network games between different machines. Only a select few RNGs are
-// used for the sum, because not all RNGs are important to network sync.
+// of network games between different machines. Only named RNGs are used for
+// the sum since those are the ones which are part of the play simulation.
 //
 //==========================================================================
 
 DWORD FRandom::StaticSumSeeds ()
 {
-	return pr_spawnmobj.sfmt.u[0] + pr_spawnmobj.idx +
-		pr_chase.sfmt.u[0] + pr_chase.idx;
+	DWORD sum = 0;
+	for (FRandom *rng = FRandom::RNGList; rng != NULL; rng = rng->Next)
+	{
+		if (rng->NameCRC != 0)
+			sum = sum*31 + rng->sfmt.u[0] + rng->idx;
+	}
+	return sum;
+}
+
+//==========================================================================
+//
+// FRandom :: StaticPrintSeeds
+//
+// Writes the state of every named RNG in a form that can be compared
+// between machines when a network game goes out of sync.
+//
+//==========================================================================
+
+void FRandom::StaticPrintSeeds (FILE *file)
+{
+	for (FRandom *rng = FRandom::RNGList; rng != NULL; rng = rng->Next)
+	{
+		if (rng->NameCRC == 0)
+			continue;
+
+#ifndef NDEBUG
+		fprintf (file, "%08X %-24s idx=%d u0=%08X\n", rng->NameCRC, rng->Name, rng->idx, rng->sfmt.u[0]);
+#else
+		fprintf (file, "%08X idx=%d u0=%08X\n", rng->NameCRC, rng->idx, rng->sfmt.u[0]);
+#endif
+	}
 }
 
 //==========================================================================
@@ -291,6 +320,35 @@ void FRandom::StaticWriteRNGState (FILE *file)
 	}
 }
 
+//==========================================================================
+//
+// FRandom :: StaticSerializeRNGState
+//
+// Stores or restores the state of every named RNG for an in memory snapshot.
+// Since the RNG list can't change while the game is running there is no need
+// to identify RNGs by CRC and the state can be copied as a block.
+//
+//==========================================================================
+
+void FRandom::StaticSerializeRNGState (FArchive &arc)
+{
+	assert (!arc.IsPeristent());
+
+	arc << rngseed;
+
+	for (FRandom *rng = FRandom::RNGList; rng != NULL; rng = rng->Next)
+	{
+		if (rng->NameCRC == 0)
+			continue;
+
+		arc << rng->idx << rng->oldidx;
+		if (arc.IsStoring())
+			arc.Write (rng->sfmt.u, sizeof(rng->sfmt.u));
+		else
+			arc.Read (rng->sfmt.u, sizeof(rng->sfmt.u));
+	}
+}
+
 //==========================================================================
 //
 // FRandom :: StaticReadRNGState
@@ -40,6 +40,7 @@
 #include "sfmt/SFMT.h"
 
 struct PNGHandle;
+class FArchive;
 
 class FRandom
 {
@@ -178,11 +179,9 @@ public:
 	static DWORD StaticSumSeeds ();
 	static void StaticReadRNGState (PNGHandle *png);
 	static void StaticWriteRNGState (FILE *file);
+	static void StaticSerializeRNGState (FArchive &arc);
 	static FRandom *StaticFindRNG(const char *name);
-
-#ifndef NDEBUG
-//	static void StaticPrintSeeds ();
-#endif
+	static void StaticPrintSeeds (FILE *file);
 
 private:
 #ifndef NDEBUG
@@ -374,14 +374,17 @@ void R_LoadSprite(const FString &name)
 ////////////////////////////////////////////////////////////////////////////////
 
 // From wl_draw.cpp
-unsigned int CalcRotate(AActor *ob);
-extern byte* vbuf;
-extern unsigned vbufPitch;
-extern int viewshift;
-extern fixed viewz;
+unsigned int CalcRotate(const RenderContext &ctx, AActor *ob);
 
-void ScaleSprite(AActor *actor, int xcenter, const Frame *frame, unsigned height)
+void ScaleSprite(const RenderContext &ctx, AActor *actor, int xcenter, const Frame *frame, unsigned height)
 {
+	const int viewwidth = ctx.viewwidth;
+	const int viewheight = ctx.viewheight;
+	const int viewshift = ctx.viewshift;
+	const fixed viewz = ctx.viewz;
+	byte* const vbuf = ctx.buf;
+	const unsigned vbufPitch = ctx.pitch;
+
 	// height is a 13.3 fixed point number indicating the number of screen
 	// pixels that the sprite should occupy.
 	if(height < 8)
@@ -405,17 +408,19 @@ void ScaleSprite(AActor *actor, int xcenter, const Frame *frame, unsigned height
 		tex = TexMan[spr.texture[0]];
 	else
 	{
-		const unsigned int rot = CalcRotate(actor);
+		const unsigned int rot = CalcRotate(ctx, actor);
 		tex = TexMan[spr.texture[rot]];
 		flip = (spr.mirror>>rot)&1;
 	}
 	if(tex == NULL)
 		return;
 
+	TexMan.MarkUsed(tex);
+
 	const double dyScale = (height/256.0)*FIXED2FLOAT(actor->scaleY);
 	const int upperedge = topoffset + height - static_cast<int>((tex->GetScaledTopOffsetDouble())*dyScale*8);
 
-	const double dxScale = (height/256.0)*FIXED2FLOAT(FixedDiv(actor->scaleX, yaspect));
+	const double dxScale = (height/256.0)*FIXED2FLOAT(FixedDiv(actor->scaleX, ctx.yaspect));
 	const int actx = static_cast<int>(xcenter - tex->GetScaledLeftOffsetDouble()*dxScale);
 
 	const unsigned int texWidth = tex->GetWidth();
@@ -431,8 +436,8 @@ void ScaleSprite(AActor *actor, int xcenter, const Frame *frame, unsigned height
 		colormap = NormalLight.Maps;
 	else
 	{
-		const int shade = LIGHT2SHADE(gLevelLight + r_extralight);
-		const int tz = FixedMul(r_depthvisibility<<8, height);
+		const int shade = LIGHT2SHADE(gLevelLight + ctx.extralight);
+		const int tz = FixedMul(ctx.depthvisibility<<8, height);
 		colormap = &NormalLight.Maps[GETPALOOKUP(MAX(tz, MINZ), shade)<<8];
 	}
 	const BYTE *src;
@@ -442,7 +447,7 @@ void ScaleSprite(AActor *actor, int xcenter, const Frame *frame, unsigned height
 	fixed x, y;
 	for(i = actx+startX, x = startX*xStep;x < xRun;x += xStep, ++i, dest = ++destBase)
 	{
-		if(wallheight[i] > (signed)height)
+		if(ctx.wallheight[i] > (signed)height)
 			continue;
 
 		src = tex->GetColumn(flip ? texWidth - (x>>FRACBITS) - 1 : (x>>FRACBITS), NULL);
@@ -456,14 +461,21 @@ void ScaleSprite(AActor *actor, int xcenter, const Frame *frame, unsigned height
 	}
 }
 
-void Scale3DSpriter(AActor *actor, int x1, int x2, FTexture *tex, bool flip, const Frame *frame, fixed ny1, fixed ny2, fixed nx1, fixed nx2)
+void Scale3DSpriter(const RenderContext &ctx, AActor *actor, int x1, int x2, FTexture *tex, bool flip, const Frame *frame, fixed ny1, fixed ny2, fixed nx1, fixed nx2)
 {
 	if(actor->sprite == SPR_NONE || loadedSprites[actor->sprite].numFrames == 0)
 		return;
 
+	const int viewwidth = ctx.viewwidth;
+	const int viewheight = ctx.viewheight;
+	const int viewshift = ctx.viewshift;
+	const fixed viewz = ctx.viewz;
+	byte* const vbuf = ctx.buf;
+	const unsigned vbufPitch = ctx.pitch;
+
 	const unsigned int texWidth = tex->GetWidth();
-	unsigned height1 = (word)(heightnumerator/(nx1>>8));
-	unsigned height2 = (word)(heightnumerator/(nx2>>8));
+	unsigned height1 = (word)(ctx.heightnumerator/(nx1>>8));
+	unsigned height2 = (word)(ctx.heightnumerator/(nx2>>8));
 	
 	unsigned height = height1;
 
@@ -486,8 +498,8 @@ void Scale3DSpriter(AActor *actor, int x1, int x2, FTexture *tex, bool flip, con
 		colormap = NormalLight.Maps;
 	else
 	{
-		const int shade = LIGHT2SHADE(gLevelLight + r_extralight);
-		const int tz = FixedMul(r_depthvisibility<<8, height);
+		const int shade = LIGHT2SHADE(gLevelLight + ctx.extralight);
+		const int tz = FixedMul(ctx.depthvisibility<<8, height);
 		colormap = &NormalLight.Maps[GETPALOOKUP(MAX(tz, MINZ), shade)<<8];
 	}
 	const BYTE *src;
@@ -501,7 +513,7 @@ void Scale3DSpriter(AActor *actor, int x1, int x2, FTexture *tex, bool flip, con
 	fixed dxa = 0, dza = 0;
 	dxx/=(signed)texWidth,dzz/=(signed)texWidth;
 	dxa+=dxx,dza+=dzz;
-	int nexti = (int)((ny1+(dxa>>8))*::scale/(nx1+(dza>>8))+centerx);
+	int nexti = (int)((ny1+(dxa>>8))*ctx.scale/(nx1+(dza>>8))+ctx.centerx);
 	src = tex->GetColumn(flip ? texWidth - 1 : 0, NULL);
 
 	for(i = x1, x = 0; i < x2; ++i)
@@ -514,7 +526,7 @@ void Scale3DSpriter(AActor *actor, int x1, int x2, FTexture *tex, bool flip, con
 
 			dxa += dxx;
 			dza += dzz;
-			nexti = (int)((ny1+(dxa>>8))*::scale/(nx1+(dza>>8))+centerx);
+			nexti = (int)((ny1+(dxa>>8))*ctx.scale/(nx1+(dza>>8))+ctx.centerx);
 		}
 
 		// linear interpolation oh no
@@ -524,7 +536,7 @@ void Scale3DSpriter(AActor *actor, int x1, int x2, FTexture *tex, bool flip, con
 		scale = height>>3;
 		topoffset = (scale*(viewz+(actor->z<<6)+(32<<FRACBITS))/(32<<FRACBITS));
 
-		if(i < 0 || i >= viewwidth || wallheight[i] > (signed)height || scale == 0 || -(viewheight/2 - viewshift - topoffset) >= scale)
+		if(i < 0 || i >= viewwidth || ctx.wallheight[i] > (signed)height || scale == 0 || -(viewheight/2 - viewshift - topoffset) >= scale)
 			continue;
 		
 		dest = vbuf + i + (upperedge > 0 ? vbufPitch*upperedge : 0);
@@ -545,10 +557,10 @@ void Scale3DSpriter(AActor *actor, int x1, int x2, FTexture *tex, bool flip, con
 }
 
 bool UseWolf4SDL3DSpriteScaler = false;
-void Scale3DShaper(int, int, FTexture *, uint32_t, fixed, fixed, fixed, fixed, byte *, unsigned);
+void Scale3DShaper(const RenderContext &, int, int, FTexture *, uint32_t, fixed, fixed, fixed, fixed);
 
 // This function from Wolf4SDL more or less verbatim at the moment.
-void Scale3DSprite(AActor *actor, const Frame *frame, unsigned height)
+void Scale3DSprite(const RenderContext &ctx, AActor *actor, const Frame *frame, unsigned height)
 {
 	bool flip = false;
 	const Sprite &spr = spriteFrames[loadedSprites[actor->sprite].frames+frame->frame];
@@ -557,17 +569,22 @@ void Scale3DSprite(AActor *actor, const Frame *frame, unsigned height)
 		tex = TexMan[spr.texture[0]];
 	else
 	{
-		const unsigned int rot = CalcRotate(actor);
+		const unsigned int rot = CalcRotate(ctx, actor);
 		tex = TexMan[spr.texture[rot]];
 		flip = (spr.mirror>>rot)&1;
 	}
 	if(tex == NULL)
 		return;
 
+	TexMan.MarkUsed(tex);
+
+	const fixed viewsin = ctx.viewsin;
+	const fixed viewcos = ctx.viewcos;
+
 	fixed nx1,nx2,ny1,ny2;
 	int viewx1,viewx2;
-	fixed playx = viewx;
-	fixed playy = viewy;
+	fixed playx = ctx.viewx;
+	fixed playy = ctx.viewy;
 
 	fixed gy1,gy2,gx1,gx2,gyt1,gyt2,gxt1,gxt2;
 
@@ -603,35 +620,35 @@ void Scale3DSprite(AActor *actor, const Frame *frame, unsigned height)
 	if(nx2>=0 && nx2<=1792) nx2=1792;
 	if(nx2<0 && nx2>=-1792) nx2=-1792;
 
-	viewx1=(int)(centerx+ny1*scale/nx1);
-	viewx2=(int)(centerx+ny2*scale/nx2);
+	viewx1=(int)(ctx.centerx+ny1*ctx.scale/nx1);
+	viewx2=(int)(ctx.centerx+ny2*ctx.scale/nx2);
 
 	// Switch between original Wolf4SDL scaler and a new one.
 	if(UseWolf4SDL3DSpriteScaler)
 	{
 		if(viewx2 < viewx1)
 		{
-			Scale3DShaper(viewx2,viewx1+1,tex,0,ny2,ny1,nx2,nx1,vbuf,vbufPitch);
+			Scale3DShaper(ctx,viewx2,viewx1+1,tex,0,ny2,ny1,nx2,nx1);
 		}
 		else
 		{
-			Scale3DShaper(viewx1,viewx2+1,tex,0,ny1,ny2,nx1,nx2,vbuf,vbufPitch);
+			Scale3DShaper(ctx,viewx1,viewx2+1,tex,0,ny1,ny2,nx1,nx2);
 		}
 	}
 	else
 	{
 		if(viewx2 < viewx1)
 		{
-			Scale3DSpriter(actor, viewx2, viewx1+1, tex, flip, frame, ny2, ny1, nx2, nx1);
+			Scale3DSpriter(ctx, actor, viewx2, viewx1+1, tex, flip, frame, ny2, ny1, nx2, nx1);
 		}
 		else
 		{
-			Scale3DSpriter(actor, viewx1, viewx2+1, tex, flip, frame, ny1, ny2, nx1, nx2);
+			Scale3DSpriter(ctx, actor, viewx1, viewx2+1, tex, flip, frame, ny1, ny2, nx1, nx2);
 		}
 	}
 }
 
-void R_DrawPlayerSprite(AActor *actor, const Frame *frame, fixed offsetX, fixed offsetY)
+void R_DrawPlayerSprite(const RenderContext &ctx, AActor *actor, const Frame *frame, fixed offsetX, fixed offsetY)
 {
 	if(frame->spriteInf == SPR_NONE || loadedSprites[frame->spriteInf].numFrames == 0)
 		return;
@@ -641,10 +658,12 @@ void R_DrawPlayerSprite(AActor *actor, const Frame *frame, fixed offsetX, fixed
 	if(spr.rotations == 0)
 		tex = TexMan[spr.texture[0]];
 	else
-		tex = TexMan[spr.texture[(CalcRotate(actor)+4)%8]];
+		tex = TexMan[spr.texture[(CalcRotate(ctx, actor)+4)%8]];
 	if(tex == NULL)
 		return;
 
+	TexMan.MarkUsed(tex);
+
 	const BYTE *colormap;
 	if(frame->fullbright)
 		colormap = NormalLight.Maps;
@@ -654,11 +673,18 @@ void R_DrawPlayerSprite(AActor *actor, const Frame *frame, fixed offsetX, fixed
 		colormap = &NormalLight.Maps[GETPALOOKUP(0, shade)<<8];
 	}
 
+	const int viewwidth = ctx.viewwidth;
+	const int viewheight = ctx.viewheight;
+	const fixed pspritexscale = ctx.pspritexscale;
+	const fixed pspriteyscale = ctx.pspriteyscale;
+	byte* const vbuf = ctx.buf;
+	const unsigned vbufPitch = ctx.pitch;
+
 	const fixed scale = viewheight<<(FRACBITS-1);
 
-	const fixed centeringOffset = (centerx - 2*centerxwide)<<FRACBITS;
+	const fixed centeringOffset = (ctx.centerx - 2*ctx.centerxwide)<<FRACBITS;
 	const fixed leftedge = FixedMul((160<<FRACBITS) - fixed(tex->GetScaledLeftOffsetDouble()*FRACUNIT) + offsetX, pspritexscale) + centeringOffset;
-	fixed upperedge = ((100-32)<<FRACBITS) + fixed(tex->GetScaledTopOffsetDouble()*FRACUNIT) - offsetY - AspectCorrection[r_ratio].tallscreen;
+	fixed upperedge = ((100-32)<<FRACBITS) + fixed(tex->GetScaledTopOffsetDouble()*FRACUNIT) - offsetY - AspectCorrection[ctx.ratio].tallscreen;
 	if(viewsize == 21 && players[ConsolePlayer].ReadyWeapon)
 	{
 		upperedge -= players[ConsolePlayer].ReadyWeapon->yadjust;
@@ -732,7 +758,7 @@ void SpriteZoomer::Draw()
 	// (vanilla could crash) and our player sprite renderer may take
 	// into account things we would rather not have here.
 	const double yscale = double(viewheight*count)/double(zoomtime*64);
-	const double xscale = yscale/FIXED2FLOAT(yaspect);
+	const double xscale = yscale/FIXED2FLOAT(r_mainview.yaspect);
 
 	screen->DrawTexture(gmoverTex, viewscreenx + (viewwidth>>1), viewscreeny + (viewheight>>1) + yscale*32,
 		DTA_DestWidthF, gmoverTex->GetScaledWidthDouble()*xscale,
@@ -38,6 +38,8 @@
 #include "actor.h"
 #include "zstring.h"
 
+struct RenderContext;
+
 enum SpecialSprites
 {
 	SPR_NONE,
@@ -52,9 +54,9 @@ void R_GetSpriteHitlist(BYTE* hitlist);
 void R_InitSprites();
 void R_LoadSprite(const FString &name);
 
-void ScaleSprite(AActor *actor, int xcenter, const Frame *frame, unsigned height);
-void Scale3DSprite(AActor *actor, const Frame *frame, unsigned height);
-void R_DrawPlayerSprite(AActor *actor, const Frame *frame, fixed offsetX, fixed offsetY);
+void ScaleSprite(const RenderContext &ctx, AActor *actor, int xcenter, const Frame *frame, unsigned height);
+void Scale3DSprite(const RenderContext &ctx, AActor *actor, const Frame *frame, unsigned height);
+void R_DrawPlayerSprite(const RenderContext &ctx, AActor *actor, const Frame *frame, fixed offsetX, fixed offsetY);
 
 // For FArchive
 unsigned int R_GetNumLoadedSprites();
@@ -141,6 +141,10 @@ bool FGamemaps::Open(bool quiet)
 	static const unsigned int NUM_MAP_LUMPS = 2;
 	NumLumps *= NUM_MAP_LUMPS;
 
+	// Maps can only be expanded off the main thread if they can get a reader
+	// of their own, which isn't the case when embedded in another archive.
+	const bool reopenable = FileReader().Open(Filename);
+
 	Lumps = new FMapLump[NumLumps];
 	for(unsigned int i = 0;i < NumLumps/NUM_MAP_LUMPS;++i)
 	{
@@ -166,6 +170,8 @@ bool FGamemaps::Open(bool quiet)
 		dataLump.Owner = this;
 		dataLump.LumpNameSetup("PLANES");
 		dataLump.Namespace = ns_global;
+		if(reopenable)
+			dataLump.Flags |= LUMPF_THREADSAFE;
 		for(unsigned int j = 0;j < PLANES;j++)
 		{
 			dataLump.Header.PlaneOffset[j] = ReadLittleLong(&header[4*j]);
@@ -98,6 +98,10 @@ bool FRtlFile::Open(bool quiet)
 			NumLumps += NUM_MAP_LUMPS;
 	}
 
+	// Maps can only be expanded off the main thread if they can get a reader
+	// of their own, which isn't the case when embedded in another archive.
+	const bool reopenable = FileReader().Open(Filename);
+
 	Lumps = new FMapLump[NumLumps];
 	// Preserve map position in the MAPxy notation
 	for(unsigned int i = 0;i < 100;++i)
@@ -119,6 +123,8 @@ bool FRtlFile::Open(bool quiet)
 		dataLump.Owner = this;
 		dataLump.LumpNameSetup("PLANES");
 		dataLump.Namespace = ns_global;
+		if(reopenable)
+			dataLump.Flags |= LUMPF_THREADSAFE;
 		for(unsigned int j = 0;j < PLANES;j++)
 		{
 			dataLump.Header.PlaneOffset[j] = LittleLong(header[i].planeOffset[j]);
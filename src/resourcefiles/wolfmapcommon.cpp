@@ -32,8 +32,21 @@
 **
 */
 
+#include <SDL.h>
 #include "wolfmapcommon.h"
 
+// Planes at least this large (in bytes) are expanded in their own threads.
+// Vanilla sized maps expand faster than a thread can be started.
+static const unsigned int PARALLEL_PLANE_SIZE = 128*128*2;
+
+struct FMapPlaneJob
+{
+	FMapLump *lump;
+	const unsigned char *in;
+	unsigned char *out;
+	unsigned int planeSize;
+};
+
 // Only important thing to remember is that both
 // Compression methods work on WORDs rather than bytes.
 
@@ -106,6 +119,31 @@ void FMapLump::ExpandRLEW(const unsigned char* in, unsigned char* out, const DWO
 	}
 }
 
+void FMapLump::ExpandPlane(const unsigned char* in, unsigned char* out, const unsigned int planeSize)
+{
+	if(carmackCompressed)
+	{
+		unsigned char* tempOut = new unsigned char[ReadLittleShort(in)];
+		ExpandCarmack(in, tempOut);
+		ExpandRLEW(tempOut+2, out, ReadLittleShort((const BYTE*)tempOut), rlewTag);
+		delete[] tempOut;
+	}
+	else
+	{
+		if(rtlMap)
+			ExpandRLEW(in, out, planeSize, rlewTag);
+		else
+			ExpandRLEW(in+2, out, ReadLittleShort(in), rlewTag);
+	}
+}
+
+int FMapLump::ExpandPlaneThread(void *data)
+{
+	FMapPlaneJob *job = static_cast<FMapPlaneJob *>(data);
+	job->lump->ExpandPlane(job->in, job->out, job->planeSize);
+	return 0;
+}
+
 int FMapLump::FillCache()
 {
 	if(LumpSize == 0)
@@ -121,42 +159,35 @@ int FMapLump::FillCache()
 	WriteLittleShort((BYTE*)&Cache[HEADERSIZE-2], Header.Height);
 	memcpy(&Cache[14], Header.Name, 16);
 
-	// Read map data and expand it
+	// Every map in the file shares the owner's reader, so lumps which may be
+	// cached off the main thread read through a handle of their own.
+	FileReader privateReader;
+	FileReader *reader = Owner->Reader;
+	if((Flags & LUMPF_THREADSAFE) && privateReader.Open(Owner->Filename))
+		reader = &privateReader;
+
+	// Read the compressed planes and lay out where they will expand to. The
+	// reader isn't thread safe so this is all done up front.
+	FMapPlaneJob jobs[PLANES];
 	unsigned char* output = reinterpret_cast<unsigned char*>(Cache+HEADERSIZE);
 	for(unsigned int i = 0;i < PLANES;++i)
 	{
+		jobs[i].lump = this;
+		jobs[i].in = NULL;
+		jobs[i].out = output;
+		jobs[i].planeSize = PlaneSize;
+
 		// ChaosEdit HACK: Likely in order to save a few bytes ChaosEdit sets
 		// the second and third map plane offsets to be the same (since vanilla
 		// doesn't use the data). If we see this we need to zero fill the plane.
 		if(i == 2 && Header.PlaneOffset[1] == Header.PlaneOffset[2] && !rtlMap)
-		{
 			memset(output, 0, PlaneSize);
-			output += PlaneSize;
-			continue;
-		}
-
-		if(Header.PlaneLength[i])
+		else if(Header.PlaneLength[i])
 		{
 			unsigned char* input = new unsigned char[Header.PlaneLength[i]];
-			Owner->Reader->Seek(Header.PlaneOffset[i], SEEK_SET);
-			Owner->Reader->Read(input, Header.PlaneLength[i]);
-
-			if(carmackCompressed)
-			{
-				unsigned char* tempOut = new unsigned char[ReadLittleShort((BYTE*)input)];
-				ExpandCarmack(input, tempOut);
-				ExpandRLEW(tempOut+2, output, ReadLittleShort((const BYTE*)tempOut), rlewTag);
-				delete[] tempOut;
-			}
-			else
-			{
-				if(rtlMap)
-					ExpandRLEW(input, output, PlaneSize, rlewTag);
-				else
-					ExpandRLEW(input+2, output, ReadLittleShort((const BYTE*)input), rlewTag);
-			}
-
-			delete[] input;
+			reader->Seek(Header.PlaneOffset[i], SEEK_SET);
+			reader->Read(input, Header.PlaneLength[i]);
+			jobs[i].in = input;
 		}
 		else
 			memset(output, 0, PlaneSize);
@@ -171,5 +202,28 @@ int FMapLump::FillCache()
 			output += PlaneSize;
 		}
 	}
+
+	// Each plane expands independently so on large maps hand all but the
+	// first off to other threads. If a thread can't be created (for example
+	// on platforms without thread support) just expand it here.
+	SDL_Thread *threads[PLANES];
+	for(unsigned int i = PLANES;i-- > 0;)
+	{
+		threads[i] = NULL;
+		if(!jobs[i].in)
+			continue;
+
+		if(i > 0 && PlaneSize >= PARALLEL_PLANE_SIZE)
+			threads[i] = SDL_CreateThread(ExpandPlaneThread, "ExpandPlane", &jobs[i]);
+		if(!threads[i])
+			ExpandPlane(jobs[i].in, jobs[i].out, PlaneSize);
+	}
+
+	for(unsigned int i = 0;i < PLANES;++i)
+	{
+		if(threads[i])
+			SDL_WaitThread(threads[i], NULL);
+		delete[] jobs[i].in;
+	}
 	return 1;
 }
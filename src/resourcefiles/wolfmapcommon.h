@@ -37,6 +37,7 @@
 
 #include "files.h"
 #include "resourcefile.h"
+#include "w_wad.h"
 
 #define RTLCONVERTEDPLANES 4
 #define PLANES 3
@@ -49,6 +50,8 @@ struct FMapLump : public FResourceLump
 	protected:
 		void ExpandCarmack(const unsigned char* in, unsigned char* out);
 		void ExpandRLEW(const unsigned char* in, unsigned char* out, const DWORD length, const WORD rlewTag);
+		void ExpandPlane(const unsigned char* in, unsigned char* out, const unsigned int planeSize);
+		static int ExpandPlaneThread(void *data);
 
 		int FillCache();
 	public:
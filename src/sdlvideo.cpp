@@ -315,6 +315,7 @@ private:
 
 	void UpdateColors ();
 	void ResetSDLRenderer ();
+	void CopyRect (void *pixels, int pitch, const DirtyRect &rect);
 
 	SDLFB () {}
 };
@@ -834,6 +835,7 @@ void SDLFB::Update ()
 	{
 		NeedPalUpdate = false;
 		UpdateColors ();
+		MarkAllDirty ();
 	}
 
 #if 0
@@ -854,46 +856,36 @@ void SDLFB::Update ()
 	//BlitCycles.Clock();
 
 #if SDL_VERSION_ATLEAST(2,0,0)
-	void *pixels;
-	int pitch;
-	if (UsingRenderer)
+	// Only convert and upload what changed since the last frame. The texture
+	// (or window surface) keeps its contents, so a frame where only the view
+	// or a status bar number changed touches just those pixels. Each rect
+	// is locked on its own so SDL only has to send that part to the GPU.
+	const DirtyRect *rects;
+	unsigned numrects;
+	DirtyRect full;
+	if (GetDirtyRects (rects, numrects))
 	{
-		if (SDL_LockTexture (Texture, NULL, &pixels, &pitch))
-			return;
+		full.left = full.top = 0;
+		full.right = Width;
+		full.bottom = Height;
+		rects = &full;
+		numrects = 1;
 	}
-	else
-	{
-		if (SDL_LockSurface (Surface))
-			return;
 
-		pixels = Surface->pixels;
-		pitch = Surface->pitch;
-	}
-
-	if (NotPaletted)
-	{
-		GPfx.Convert (MemBuffer, Pitch,
-			pixels, pitch, Width, Height,
-			FRACUNIT, FRACUNIT, 0, 0);
-	}
-	else
+	void *pixels;
+	int pitch;
+	if (UsingRenderer)
 	{
-		if (pitch == Pitch)
-		{
-			memcpy (pixels, MemBuffer, Width*Height);
-		}
-		else
+		for (unsigned i = 0; i < numrects; ++i)
 		{
-			for (int y = 0; y < Height; ++y)
-			{
-				memcpy ((BYTE *)pixels+y*pitch, MemBuffer+y*Pitch, Width);
-			}
-		}
-	}
+			SDL_Rect area = { rects[i].left, rects[i].top, rects[i].right - rects[i].left, rects[i].bottom - rects[i].top };
+			if (SDL_LockTexture (Texture, rects == &full ? NULL : &area, &pixels, &pitch))
+				return;
 
-	if (UsingRenderer)
-	{
-		SDL_UnlockTexture (Texture);
+			CopyRect (pixels, pitch, rects[i]);
+			SDL_UnlockTexture (Texture);
+		}
+		ClearDirty ();
 
 		//SDLFlipCycles.Clock();
 		SDL_RenderClear(Renderer);
@@ -910,10 +902,25 @@ void SDLFB::Update ()
 	}
 	else
 	{
+		if (SDL_LockSurface (Surface))
+			return;
+
+		SDL_Rect areas[MAX_DIRTY_RECTS];
+		for (unsigned i = 0; i < numrects; ++i)
+		{
+			SDL_Rect area = { rects[i].left, rects[i].top, rects[i].right - rects[i].left, rects[i].bottom - rects[i].top };
+			areas[i] = area;
+
+			pixels = (BYTE *)Surface->pixels + area.y*Surface->pitch + area.x*Surface->format->BytesPerPixel;
+			CopyRect (pixels, Surface->pitch, rects[i]);
+		}
+		ClearDirty ();
+
 		SDL_UnlockSurface (Surface);
 
 		//SDLFlipCycles.Clock();
-		SDL_UpdateWindowSurface (Screen);
+		if (numrects)
+			SDL_UpdateWindowSurfaceRects (Screen, areas, numrects);
 		//SDLFlipCycles.Unclock();
 	}
 
@@ -943,6 +950,7 @@ void SDLFB::Update ()
 	}
 	
 	SDL_UnlockSurface (Screen);
+	ClearDirty ();
 
 #if 0
 	if (cursorSurface != NULL && GUICapture)
@@ -960,6 +968,34 @@ void SDLFB::Update ()
 	//BlitCycles.Unclock();
 }
 
+void SDLFB::CopyRect (void *pixels, int pitch, const DirtyRect &rect)
+{
+	BYTE *src = MemBuffer + rect.top*Pitch + rect.left;
+	int width = rect.right - rect.left;
+	int height = rect.bottom - rect.top;
+
+	if (NotPaletted)
+	{
+		GPfx.Convert (src, Pitch,
+			pixels, pitch, width, height,
+			FRACUNIT, FRACUNIT, 0, 0);
+	}
+	else
+	{
+		if (pitch == Pitch && width == Width)
+		{
+			memcpy (pixels, src, width*height);
+		}
+		else
+		{
+			for (int y = 0; y < height; ++y)
+			{
+				memcpy ((BYTE *)pixels+y*pitch, src+y*Pitch, width);
+			}
+		}
+	}
+}
+
 void SDLFB::UpdateColors ()
 {
 	if (NotPaletted)
@@ -1140,6 +1176,9 @@ void SDLFB::ResetSDLRenderer ()
 		ScaleWithAspect (w, h, Width, Height);
 		SDL_RenderSetLogicalSize (Renderer, w, h);
 	}
+
+	// New texture or surface, nothing on it is current
+	MarkAllDirty ();
 #endif
 }
 
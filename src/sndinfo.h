@@ -39,12 +39,10 @@
 #include "tmemory.h"
 #include "name.h"
 #include "zstring.h"
+#include "id_sd_mix.h"
 
 class SoundInformation;
 
-struct Mix_Chunk;
-struct Mix_ChunkDeleter;
-
 class SoundIndex
 {
 	public:
@@ -72,7 +70,7 @@ class SoundData
 		~SoundData();
 
 		byte* GetAdLibData() const { return adlibData; }
-		Mix_Chunk *GetDigitalData() const { return digitalData; }
+		FDigiSample *GetDigitalData() const { return digitalData; }
 		unsigned short GetPriority() const { return priority; }
 		byte* GetSpeakerData() const { return speakerData; }
 		bool HasType(Type type=ADLIB) const { return lump[type] != -1; }
@@ -85,7 +83,7 @@ class SoundData
 	protected:
 		FString logicalName;
 		SoundIndex index;
-		TUniquePtr<Mix_Chunk, Mix_ChunkDeleter> digitalData;
+		TUniquePtr<FDigiSample> digitalData;
 		TUniquePtr<byte[]> adlibData, speakerData;
 		int lump[3];
 		unsigned short priority;
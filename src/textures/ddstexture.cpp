@@ -385,11 +385,6 @@ void FDDSTexture::CalcBitShift (DWORD mask, BYTE *lshiftp, BYTE *rshiftp)
 FDDSTexture::~FDDSTexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -405,6 +400,11 @@ void FDDSTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if (Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -74,7 +74,16 @@ public:
 			MakeTexture();
 		return Pixels;
 	}
-	void Unload () { Pixels.Reset(); }
+	~FMacHudTexture () { Unload (); }
+	void Unload ()
+	{
+		Pixels.Reset();
+		if (Spans != NULL)
+		{
+			FreeSpans (Spans);
+			Spans = NULL;
+		}
+	}
 
 protected:
 	TUniquePtr<BYTE[]> Pixels;
@@ -365,11 +365,6 @@ FMultiPatchTexture::~FMultiPatchTexture ()
 		delete[] Inits;
 		Inits = NULL;
 	}
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -400,6 +395,11 @@ void FMultiPatchTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if (Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -161,11 +161,6 @@ FPatchTexture::FPatchTexture (int lumpnum, patch_t * header)
 FPatchTexture::~FPatchTexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -181,6 +176,11 @@ void FPatchTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if (Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -386,10 +386,6 @@ void FPatchTexture::HackHack (int newheight)
 		{ 
 			// If all the columns were checked, it needs fixing.
 			Unload ();
-			if (Spans != NULL)
-			{
-				FreeSpans (Spans);
-			}
 
 			Height = newheight;
 			LeftOffset = 0;
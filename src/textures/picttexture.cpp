@@ -126,7 +126,16 @@ public:
 			MakeTexture();
 		return Pixels;
 	}
-	void Unload () { Pixels.Reset(); }
+	~FPictTexture () { Unload (); }
+	void Unload ()
+	{
+		Pixels.Reset();
+		if (Spans != NULL)
+		{
+			FreeSpans (Spans);
+			Spans = NULL;
+		}
+	}
 
 protected:
 	TUniquePtr<BYTE[]> Pixels;
@@ -333,11 +333,6 @@ FPNGTexture::FPNGTexture (FileReader &lump, int lumpnum, const FString &filename
 FPNGTexture::~FPNGTexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 	if (PaletteMap != NULL && PaletteMap != GrayMap)
 	{
 		delete[] PaletteMap;
@@ -420,6 +415,11 @@ void FPNGTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if (Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
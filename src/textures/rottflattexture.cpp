@@ -127,11 +127,6 @@ FRottFlatTexture::FRottFlatTexture(int lumpnum, FileReader &file)
 FRottFlatTexture::~FRottFlatTexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -147,6 +142,11 @@ void FRottFlatTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if(Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
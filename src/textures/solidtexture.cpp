@@ -121,11 +121,6 @@ FSolidTexture::FSolidTexture(DWORD color) : FTexture(NULL, -1), Pixels(NULL),
 FSolidTexture::~FSolidTexture ()
 {
 	Unload();
-	if(Spans)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -141,6 +136,11 @@ void FSolidTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if(Spans)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -167,7 +167,7 @@ FTexture::FTexture (const char *name, int lumpnum)
   WidthBits(0), HeightBits(0), xScale(FRACUNIT), yScale(FRACUNIT), SourceLump(lumpnum),
   UseType(TEX_Any), bNoDecals(false), bNoRemap0(false), bWorldPanning(false),
   bMasked(true), bAlphaTexture(false), bHasCanvas(false), bWarped(0), bComplex(false), bMultiPatch(false), bKeepAround(false),
-  Rotations(0xFFFF), SkyOffset(0), Width(0), Height(0), WidthMask(0)/*, Native(NULL)*/
+  Rotations(0xFFFF), SkyOffset(0), CacheFrame(0), bCached(false), CacheCost(0), Width(0), Height(0), WidthMask(0)/*, Native(NULL)*/
 {
 	id.SetInvalid();
 	if (name != NULL)
@@ -335,6 +335,14 @@ void FTexture::FreeSpans (Span **spans) const
 	M_Free (spans);
 }
 
+// Estimates what Unload frees: the pixels and the span table built by
+// CreateSpans, assuming one post per column if the texture has holes.
+unsigned int FTexture::GetCacheCost () const
+{
+	const unsigned int spans = bMasked ? Width*2 : 2;
+	return Width*Height + Width*sizeof(Span*) + spans*sizeof(Span);
+}
+
 void FTexture::CopyToBlock (BYTE *dest, int dwidth, int dheight, int xpos, int ypos, int rotate, const BYTE *translation)
 {
 	const BYTE *pixels = GetPixels();
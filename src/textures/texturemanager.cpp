@@ -70,6 +70,12 @@ FTextureManager TexMan;
 //==========================================================================
 
 FTextureManager::FTextureManager ()
+#ifdef __EMSCRIPTEN__
+: CacheLimit(16*1024),
+#else
+: CacheLimit(0),
+#endif
+  CacheFrame(1), CacheSize(0), CacheHits(0), CacheMisses(0), CacheEvictions(0)
 {
 	memset (HashFirst, -1, sizeof(HashFirst));
 
@@ -101,6 +107,8 @@ void FTextureManager::DeleteAll()
 	Textures.Clear();
 	Translation.Clear();
 	FirstTextureForFile.Clear();
+	CachedTextures.Clear();
+	CacheSize = 0;
 	memset (HashFirst, -1, sizeof(HashFirst));
 	DefaultTexture.SetInvalid();
 
@@ -390,8 +398,114 @@ void FTextureManager::UnloadAll ()
 {
 	for (unsigned int i = 0; i < Textures.Size(); ++i)
 	{
-		Textures[i].Texture->Unload ();
+		UncacheTexture (Textures[i].Texture);
+	}
+}
+
+//==========================================================================
+//
+// FTextureManager :: TouchCache
+//
+// Called the first time a texture is used in a frame. Hits and misses are
+// counted per frame rather than per column.
+//
+//==========================================================================
+
+void FTextureManager::TouchCache (FTexture *tex)
+{
+	tex->CacheFrame = CacheFrame;
+	if (tex->bCached)
+	{
+		++CacheHits;
+		return;
 	}
+
+	// Canvas contents can't be recreated
+	if (tex->bHasCanvas)
+		return;
+
+	++CacheMisses;
+	tex->bCached = true;
+	tex->CacheCost = tex->GetCacheCost();
+	CacheSize += tex->CacheCost;
+	CachedTextures.Push (tex);
+}
+
+//==========================================================================
+//
+// FTextureManager :: UncacheTexture
+//
+//==========================================================================
+
+void FTextureManager::UncacheTexture (FTexture *tex)
+{
+	tex->Unload ();
+	if (tex->bCached)
+	{
+		tex->bCached = false;
+		CacheSize -= tex->CacheCost;
+		for (unsigned int i = 0; i < CachedTextures.Size(); ++i)
+		{
+			if (CachedTextures[i] == tex)
+			{
+				CachedTextures.Delete (i);
+				break;
+			}
+		}
+	}
+}
+
+//==========================================================================
+//
+// FTextureManager :: TrimCache
+//
+// Unloads the least recently used textures until the cache fits in its
+// limit again. Anything used in the frame which just ended is kept.
+//
+//==========================================================================
+
+static int CompareCacheFrame (const void *a, const void *b)
+{
+	const DWORD fa = (*(FTexture * const *)a)->CacheFrame;
+	const DWORD fb = (*(FTexture * const *)b)->CacheFrame;
+	return fa < fb ? -1 : fa > fb;
+}
+
+void FTextureManager::TrimCache ()
+{
+	if (CacheLimit != 0 && CacheSize > (size_t)CacheLimit*1024)
+	{
+		qsort (&CachedTextures[0], CachedTextures.Size(), sizeof(FTexture *), CompareCacheFrame);
+
+		unsigned int evicted = 0;
+		while (evicted < CachedTextures.Size() && CacheSize > (size_t)CacheLimit*1024)
+		{
+			FTexture *tex = CachedTextures[evicted];
+			if (tex->CacheFrame == CacheFrame)
+				break;
+
+			tex->Unload ();
+			tex->bCached = false;
+			CacheSize -= tex->CacheCost;
+			++evicted;
+		}
+		CachedTextures.Delete (0, evicted);
+		CacheEvictions += evicted;
+	}
+	++CacheFrame;
+}
+
+//==========================================================================
+//
+// FTextureManager :: PrintCacheStats
+//
+//==========================================================================
+
+void FTextureManager::PrintCacheStats () const
+{
+	Printf ("Texture cache: %u KiB in %u textures (limit %u KiB), %u hits, %u misses, %u evictions\n",
+		(unsigned int)(CacheSize/1024), CachedTextures.Size(), CacheLimit,
+		CacheHits, CacheMisses, CacheEvictions);
 }
 
 //==========================================================================
@@ -472,6 +586,10 @@ void FTextureManager::ReplaceTexture (FTextureID picnum, FTexture *newtexture, b
 	Textures[index].Texture = newtexture;
 
 	newtexture->id = oldtexture->id;
+	if (oldtexture->bCached)
+	{
+		UncacheTexture (oldtexture);
+	}
 	if (free && !oldtexture->bKeepAround)
 	{
 		delete oldtexture;
@@ -1247,6 +1365,13 @@ int FTextureManager::CountLumpTextures (int lumpnum)
 //===========================================================================
 
 void FTextureManager::PrecacheLevel (void)
+{
+	PrecacheLevel (map, true);
+}
+
+// Caches the textures used by gm. Textures not used are only unloaded if
+// requested so that a map can be precached before the current one is done.
+void FTextureManager::PrecacheLevel (const GameMap *gm, bool unloadUnused)
 {
 	BYTE *hitlist;
 	// We use +1 to account for unknown textures
@@ -1258,7 +1383,7 @@ void FTextureManager::PrecacheLevel (void)
 	hitlist = new BYTE[cnt];
 	memset (hitlist, 0, cnt);
 
-	map->GetHitlist(hitlist+1);
+	gm->GetHitlist(hitlist+1);
 	unsigned int numcached = 0;
 	for (int i = cnt - 1; i > 0; i--)
 	{
@@ -1267,15 +1392,17 @@ void FTextureManager::PrecacheLevel (void)
 		{
 			const FTexture::Span *spanp;
 			tex->GetColumn(0, &spanp);
+			MarkUsed(tex);
 			++numcached;
 		}
 		else if(hitlist[i])
 		{
 			++numcached;
 			tex->GetPixels();
+			MarkUsed(tex);
 		}
-		else
-			tex->Unload();
+		else if(unloadUnused)
+			UncacheTexture(tex);
 	}
 
 #if 0
@@ -11,6 +11,7 @@ struct FRemapTable;
 struct FCopyInfo;
 class Scanner;
 class FArchive;
+class GameMap;
 
 // Texture IDs
 class FTextureManager;
@@ -178,6 +179,11 @@ public:
 	WORD Rotations;
 	SWORD SkyOffset;
 
+	// Texture cache bookkeeping, see FTextureManager::MarkUsed
+	DWORD CacheFrame;
+	bool bCached;
+	unsigned int CacheCost;	// Bytes charged to the cache while cached
+
 	enum // UseTypes
 	{
 		TEX_Any,
@@ -233,6 +239,7 @@ public:
 
 	int GetWidth () { return Width; }
 	int GetHeight () { return Height; }
+	unsigned int GetCacheCost () const;
 
 	int GetScaledWidth () { int foo = (Width << 17) / xScale; return (foo >> 1) + (foo & 1); }
 	int GetScaledHeight () { int foo = (Height << 17) / yScale; return (foo >> 1) + (foo & 1); }
@@ -402,8 +409,23 @@ public:
 
 	void UnloadAll ();
 
+	// Textures drawn by the renderer are tracked in least recently used order
+	// so that they can be unloaded again once more than CacheLimit is taken.
+	// Textures are only unloaded by TrimCache which must be called between
+	// frames so nothing is holding on to their pixels or spans.
+	unsigned int CacheLimit;	// In KiB, 0 for no limit
+	void MarkUsed (FTexture *tex)
+	{
+		if (tex->CacheFrame != CacheFrame)
+			TouchCache (tex);
+	}
+	void TrimCache ();
+	void PrintCacheStats () const;
+	size_t GetCacheSize () const { return CacheSize; }
+
 	int NumTextures () const { return (int)Textures.Size(); }
 	void PrecacheLevel (void);
+	void PrecacheLevel (const GameMap *gm, bool unloadUnused);
 
 	void WriteTexture (FArchive &arc, int picnum);
 	int ReadTexture (FArchive &arc);
@@ -477,6 +499,15 @@ private:
 	TArray<FDoorAnimation> mAnimatedDoors;
 	TArray<BYTE *> BuildTileFiles;
 
+	// Texture cache
+	void TouchCache (FTexture *tex);
+	void UncacheTexture (FTexture *tex);
+
+	TArray<FTexture *> CachedTextures;
+	DWORD CacheFrame;
+	size_t CacheSize;
+	unsigned int CacheHits, CacheMisses, CacheEvictions;
+
 	struct TileMap
 	{
 		public:
@@ -162,11 +162,6 @@ FTGATexture::FTGATexture (int lumpnum, TGAHeader * hdr)
 FTGATexture::~FTGATexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -182,6 +177,11 @@ void FTGATexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if (Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -142,11 +142,6 @@ FWolfRawTexture::FWolfRawTexture(int lumpnum, FileReader &file)
 FWolfRawTexture::~FWolfRawTexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -162,6 +157,11 @@ void FWolfRawTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if(Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -287,11 +287,6 @@ void FWolfShapeTexture::InitMac(FileReader &file)
 FWolfShapeTexture::~FWolfShapeTexture ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -307,6 +302,11 @@ void FWolfShapeTexture::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if(Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -121,6 +121,46 @@ void ThinkerList::Tick(Priority list)
 	}
 }
 
+void ThinkerList::StorePrevStates()
+{
+	for(unsigned int i = FIRST_TICKABLE;i < NUM_TYPES;++i)
+	{
+		Iterator iter(thinkers[i]);
+		while(iter.Next())
+		{
+			Thinker *thinker = iter;
+			thinker->prevStateTic = gamestate.TimeCount;
+			thinker->StorePrevState();
+		}
+	}
+}
+
+void ThinkerList::BeginInterpolation(fixed frac)
+{
+	for(unsigned int i = FIRST_TICKABLE;i < NUM_TYPES;++i)
+	{
+		Iterator iter(thinkers[i]);
+		while(iter.Next())
+		{
+			Thinker *thinker = iter;
+			thinker->BeginInterpolation(frac);
+		}
+	}
+}
+
+void ThinkerList::EndInterpolation()
+{
+	for(unsigned int i = FIRST_TICKABLE;i < NUM_TYPES;++i)
+	{
+		Iterator iter(thinkers[i]);
+		while(iter.Next())
+		{
+			Thinker *thinker = iter;
+			thinker->EndInterpolation();
+		}
+	}
+}
+
 void ThinkerList::Serialize(FArchive &arc)
 {
 	if(arc.IsStoring())
@@ -195,7 +235,7 @@ void ThinkerList::Deregister(Thinker *thinker)
 
 IMPLEMENT_ABSTRACT_CLASS(Thinker)
 
-Thinker::Thinker(ThinkerList::Priority priority)
+Thinker::Thinker(ThinkerList::Priority priority) : prevStateTic(-1)
 {
 	Activate(priority);
 }
@@ -217,6 +257,11 @@ void Thinker::Destroy()
 	Super::Destroy();
 }
 
+bool Thinker::HasPrevState() const
+{
+	return prevStateTic == gamestate.TimeCount;
+}
+
 void Thinker::Init()
 {
 	Super::Init();
@@ -255,6 +300,9 @@ void Thinker::Serialize(FArchive &arc)
 	else
 		thinkerPriority = ThinkerList::NORMAL;
 
+	if(!arc.IsStoring())
+		prevStateTic = -1;
+
 	Super::Serialize(arc);
 }
 
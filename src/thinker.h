@@ -70,6 +70,13 @@ extern class ThinkerList
 		void	Tick();
 		void	Tick(Priority list);
 
+		// Interpolation between tics for uncapped rendering. The previous
+		// states are stored at the start of each tic and an interpolated
+		// state may be swapped in only for the duration of drawing a frame.
+		void	StorePrevStates();
+		void	BeginInterpolation(fixed frac);
+		void	EndInterpolation();
+
 		void	MarkRoots();
 	protected:
 		friend class Thinker;
@@ -103,10 +110,19 @@ class Thinker : public DObject, public EmbeddedList<Thinker>::Node
 		virtual void	PostBeginPlay() {}
 		size_t			PropagateMark();
 
+		virtual void	StorePrevState() {}
+		virtual void	BeginInterpolation(fixed frac) {}
+		virtual void	EndInterpolation() {}
+
+	protected:
+		// True if the previous state was stored at the start of this tic
+		bool			HasPrevState() const;
+
 	private:
 		friend class ThinkerList;
 
 		ThinkerList::Priority		thinkerPriority;
+		int32_t						prevStateTic;
 };
 
 #endif
@@ -286,6 +286,7 @@ void STACK_ARGS DCanvas::DrawTextureV(FTexture *img, double x, double y, uint32
 
 		dc_x = int(x0);
 		int x2_i = int(x2);
+		MarkDirty(dc_x, MAX(parms.uclip, int(floor(y0))), x2_i, MIN(parms.dclip, int(ceil(y0 + parms.destheight))));
 		fixed_t xiscale_i = FLOAT2FIXED(xiscale);
 
 		if (mode == DoDraw0)
@@ -931,6 +932,9 @@ void DCanvas::DrawLine(int x0, int y0, int x1, int y1, int palColor, uint32 real
 	Lock();
 	int deltaX, deltaY, xDir;
 
+	// The antialiasing can touch one pixel beyond either end
+	MarkDirty(MIN(x0, x1) - 1, MIN(y0, y1), MAX(x0, x1) + 2, MAX(y0, y1) + 2);
+
 	if (y0 > y1)
 	{
 		int temp = y0; y0 = y1; y1 = temp;
@@ -1082,6 +1086,7 @@ void DCanvas::DrawPixel(int x, int y, int palColor, uint32 realcolor)
 	}
 
 	Buffer[Pitch * y + x] = (BYTE)palColor;
+	MarkDirty(x, y, x + 1, y + 1);
 }
 
 //==========================================================================
@@ -1113,6 +1118,7 @@ void DCanvas::Clear (int left, int top, int right, int bottom, int palcolor, uin
 	right = MIN(Width,right);
 	top = MAX(0,top);
 	bottom = MIN(Height,bottom);
+	MarkDirty(left, top, right, bottom);
 
 	if (palcolor < 0)
 	{
@@ -1199,6 +1205,7 @@ void DCanvas::FillSimplePoly(FTexture *tex, FVector2 *points, int npoints,
 	{
 		return;
 	}
+	MarkDirty(int(floor(leftx)), int(floor(topy)), int(ceil(rightx)) + 1, int(ceil(boty)) + 1);
 
 	if(tex)
 	{
@@ -84,6 +84,7 @@ The FON2 header is followed by variable length data:
 #include "wl_def.h"
 #include "m_swap.h"
 #include "v_font.h"
+#include "v_textrun.h"
 #include "v_video.h"
 #include "w_wad.h"
 //#include "i_system.h"
@@ -515,6 +516,9 @@ FFont::FFont (const char *name, const char *nametemplate, int first, int count,
 
 FFont::~FFont ()
 {
+	// Cached strings are keyed by the font pointer
+	V_ClearTextRuns ();
+
 	if (Chars)
 	{
 		int count = LastChar - FirstChar + 1;
@@ -1970,11 +1974,6 @@ FFontChar2::FFontChar2 (int sourcelump, int sourcepos, int width, int height, in
 FFontChar2::~FFontChar2 ()
 {
 	Unload ();
-	if (Spans != NULL)
-	{
-		FreeSpans (Spans);
-		Spans = NULL;
-	}
 }
 
 //==========================================================================
@@ -1990,6 +1989,11 @@ void FFontChar2::Unload ()
 		delete[] Pixels;
 		Pixels = NULL;
 	}
+	if (Spans != NULL)
+	{
+		FreeSpans (Spans);
+		Spans = NULL;
+	}
 }
 
 //==========================================================================
@@ -2042,12 +2046,7 @@ const BYTE *FFontChar2::GetColumn (unsigned int column, const Span **spans_out)
 
 void FFontChar2::SetSourceRemap(const BYTE *sourceremap)
 {
-	Unload();
-	if(Spans) // ECWolf: Free spans since ROTT fonts have an unusual transparent color
-	{
-		FreeSpans(Spans);
-		Spans = NULL;
-	}
+	Unload(); // ECWolf: Also frees spans since ROTT fonts have an unusual transparent color
 	SourceRemap = sourceremap;
 }
 
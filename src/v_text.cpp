@@ -39,6 +39,7 @@
 
 #include "v_text.h"
 
+#include "v_textrun.h"
 #include "v_video.h"
 //#include "hu_stuff.h"
 #include "w_wad.h"
@@ -98,6 +99,8 @@ void DCanvas::DrawTextV(FFont *font, int normalcolor, int x, int y, const char *
 	int			scalex, scaley;
 	int			kerning;
 	FTexture *pic;
+	bool		cached = true;	// Can be drawn from the text run cache
+	bool		clean = false;
 
 	if (font == NULL || string == NULL)
 		return;
@@ -134,8 +137,12 @@ void DCanvas::DrawTextV(FFont *font, int normalcolor, int x, int y, const char *
 		switch (tag)
 		{
 		case TAG_IGNORE:
+			data = va_arg (tags, DWORD);
+			break;
+
 		default:
 			data = va_arg (tags, DWORD);
+			cached = false;
 			break;
 
 		case TAG_MORE:
@@ -190,12 +197,17 @@ void DCanvas::DrawTextV(FFont *font, int normalcolor, int x, int y, const char *
 			{
 				scalex = scaley = 1;
 				maxwidth = 320;
+				if (tag == DTA_Clean)
+					clean = true;
+				else
+					cached = false;
 			}
 			break;
 
 		case DTA_VirtualWidth:
 			maxwidth = va_arg (tags, int);
 			scalex = scaley = 1;
+			cached = false;
 			break;
 
 		case DTA_TextLen:
@@ -204,16 +216,44 @@ void DCanvas::DrawTextV(FFont *font, int normalcolor, int x, int y, const char *
 
 		case DTA_CellX:
 			forcedwidth = va_arg (tags, int);
+			cached = false;
 			break;
 
 		case DTA_CellY:
 			height = va_arg (tags, int);
+			cached = false;
 			break;
 		}
 		tag = va_arg (tags, uint32);
 	}
 	va_end(tags);
 
+	// Plain and clean scaled text is what gets drawn every frame, so skip
+	// setting up DrawTexture for each glyph.
+	if (cached)
+	{
+		double ox = x, oy = y;
+		if (clean)
+		{
+			ox = (x - 160.0) * CleanXfac + (Width * 0.5);
+			oy = (y - 100.0) * CleanYfac + (Height * 0.5);
+			scalex = CleanXfac;
+			scaley = CleanYfac;
+		}
+
+		FTextRunStyle style (font, (EColorRange)normalcolor, scalex, scaley);
+		style.LineHeight = height;
+		style.Kerning = kerning;
+		style.ColorEscapes = true;
+
+		size_t len = strlen (string);
+		if (len > (size_t)maxstrlen)
+			len = maxstrlen;
+		V_DrawTextRun (this, style, ox, oy, string, len);
+		va_end(taglist);
+		return;
+	}
+
 	height *= scaley;
 		
 	while ((const char *)ch - string < maxstrlen)
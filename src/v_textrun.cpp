@@ -0,0 +1,468 @@
+/*
+** v_textrun.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+**
+*/
+
+#include <cmath>
+#include <climits>
+
+#include "templates.h"
+#include "r_data/r_translate.h"
+#include "textures/textures.h"
+#include "v_palette.h"
+#include "v_text.h"
+#include "v_textrun.h"
+#include "v_video.h"
+
+enum
+{
+	NUM_RUN_BUCKETS = 256,
+
+	// Menus and the status bar only need a few dozen strings at a time.
+	MAX_TEXT_RUNS = 256,
+	MAX_TEXT_RUN_BYTES = 4*1024*1024
+};
+
+struct FTextRun
+{
+	struct Span
+	{
+		int x, y, length;
+	};
+
+	// What was drawn
+	FFont *Font;
+	EColorRange Color;
+	uint32 FillColor;
+	double ScaleX, ScaleY;
+	int LineHeight, Kerning;
+	bool ColorEscapes;
+	double SubX, SubY;	// Fractional part of the origin, which changes where pixel edges fall
+	FString Text;
+	unsigned int Hash;
+
+	// The bitmap in real pixels and its offset from the origin. Only the
+	// spans are copied so the background shows through.
+	int Left, Top, Width, Height;
+	TArray<BYTE> Pixels;
+	TArray<Span> Spans;
+	FTextRunBox Box;
+
+	FTextRun *HashNext;
+	FTextRun *Prev, *Next;	// Most recently used first
+};
+
+struct FTextRunGlyph
+{
+	FTexture *Pic;
+	const BYTE *Remap;
+	int x1, y1, x2, y2;	// Relative to the origin
+	double XStep, YStep;	// Texels per pixel
+};
+
+static FTextRun *RunBuckets[NUM_RUN_BUCKETS];
+static FTextRun *MostRecentRun, *LeastRecentRun;
+static unsigned int NumRuns, RunBytes;
+
+//==========================================================================
+//
+// HashRun
+//
+// FNV-1a over everything that affects the bitmap.
+//
+//==========================================================================
+
+static unsigned int HashBytes (unsigned int hash, const void *data, size_t len)
+{
+	const BYTE *bytes = (const BYTE *)data;
+	while (len-- > 0)
+		hash = (hash ^ *bytes++) * 16777619u;
+	return hash;
+}
+
+static unsigned int HashRun (const FTextRunStyle &style, double subx, double suby, const char *string, size_t len)
+{
+	unsigned int hash = 2166136261u;
+	hash = HashBytes (hash, &style.Font, sizeof(style.Font));
+	hash = HashBytes (hash, &style.Color, sizeof(style.Color));
+	hash = HashBytes (hash, &style.FillColor, sizeof(style.FillColor));
+	hash = HashBytes (hash, &style.ScaleX, sizeof(style.ScaleX));
+	hash = HashBytes (hash, &style.ScaleY, sizeof(style.ScaleY));
+	hash = HashBytes (hash, &style.LineHeight, sizeof(style.LineHeight));
+	hash = HashBytes (hash, &style.Kerning, sizeof(style.Kerning));
+	hash = HashBytes (hash, &style.ColorEscapes, sizeof(style.ColorEscapes));
+	hash = HashBytes (hash, &subx, sizeof(subx));
+	hash = HashBytes (hash, &suby, sizeof(suby));
+	return HashBytes (hash, string, len);
+}
+
+static bool RunMatches (const FTextRun *run, unsigned int hash, const FTextRunStyle &style, double subx, double suby, const char *string, size_t len)
+{
+	return run->Hash == hash && run->Font == style.Font && run->Color == style.Color &&
+		run->FillColor == style.FillColor && run->ScaleX == style.ScaleX && run->ScaleY == style.ScaleY &&
+		run->LineHeight == style.LineHeight && run->Kerning == style.Kerning &&
+		run->ColorEscapes == style.ColorEscapes && run->SubX == subx && run->SubY == suby &&
+		run->Text.Len() == len && memcmp(run->Text.GetChars(), string, len) == 0;
+}
+
+//==========================================================================
+//
+// LRU list
+//
+//==========================================================================
+
+static void UnlinkRecent (FTextRun *run)
+{
+	if (run->Prev)
+		run->Prev->Next = run->Next;
+	else
+		MostRecentRun = run->Next;
+
+	if (run->Next)
+		run->Next->Prev = run->Prev;
+	else
+		LeastRecentRun = run->Prev;
+}
+
+static void LinkRecent (FTextRun *run)
+{
+	run->Prev = NULL;
+	run->Next = MostRecentRun;
+	if (MostRecentRun)
+		MostRecentRun->Prev = run;
+	else
+		LeastRecentRun = run;
+	MostRecentRun = run;
+}
+
+static unsigned int RunSize (const FTextRun *run)
+{
+	return sizeof(*run) + run->Text.Len() + run->Pixels.Size() + run->Spans.Size()*sizeof(FTextRun::Span);
+}
+
+static void FreeRun (FTextRun *run)
+{
+	FTextRun **link = &RunBuckets[run->Hash % NUM_RUN_BUCKETS];
+	while (*link != run)
+		link = &(*link)->HashNext;
+	*link = run->HashNext;
+
+	UnlinkRecent (run);
+	--NumRuns;
+	RunBytes -= RunSize (run);
+	delete run;
+}
+
+//==========================================================================
+//
+// RasterizeRun
+//
+// Samples the glyphs the same way DrawTexture does: a glyph covers the
+// pixels from the truncated start to the truncated end of its scaled
+// size, and steps through the texture from its first texel. Where a glyph
+// starts is truncated after adding it to the origin, so the fractional part
+// of the origin is part of the run.
+//
+//==========================================================================
+
+static void RasterizeRun (FTextRun *run)
+{
+	TArray<FTextRunGlyph> glyphs;
+
+	FFont *font = run->Font;
+	int normalcolor = run->Color;
+	int boldcolor = normalcolor ? normalcolor - 1 : NumTextColors - 1;
+	const FRemapTable *range = font->GetColorTranslation (run->Color);
+
+	int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+	run->Box.x1 = run->Box.y1 = run->Box.x2 = run->Box.y2 = 0;
+
+	double cx = 0, cy = 0;
+	const BYTE *ch = (const BYTE *)run->Text.GetChars();
+	const BYTE *end = ch + run->Text.Len();
+	while (ch < end)
+	{
+		int c = *ch++;
+
+		if (c == TEXTCOLOR_ESCAPE && run->ColorEscapes)
+		{
+			EColorRange newcolor = V_ParseFontColor (ch, normalcolor, boldcolor);
+			if (newcolor != CR_UNDEFINED)
+			{
+				range = font->GetColorTranslation (newcolor);
+			}
+			continue;
+		}
+
+		if (c == '\n')
+		{
+			cx = 0;
+			cy += run->LineHeight;
+			continue;
+		}
+
+		int w;
+		FTexture *pic = font->GetChar (c, &w);
+		if (pic != NULL)
+		{
+			const double gx = cx - pic->GetScaledLeftOffsetDouble();
+			const double gy = cy - pic->GetScaledTopOffsetDouble();
+			const double gw = pic->GetScaledWidthDouble();
+			const double gh = pic->GetScaledHeightDouble();
+
+			if (glyphs.Size() == 0)
+			{
+				run->Box.x1 = gx;
+				run->Box.y1 = gy;
+				run->Box.x2 = gx + gw;
+				run->Box.y2 = gy + gh;
+			}
+			else
+			{
+				run->Box.x1 = MIN(run->Box.x1, gx);
+				run->Box.y1 = MIN(run->Box.y1, gy);
+				run->Box.x2 = MAX(run->Box.x2, gx + gw);
+				run->Box.y2 = MAX(run->Box.y2, gy + gh);
+			}
+
+			FTextRunGlyph glyph;
+			glyph.Pic = pic;
+			glyph.Remap = range != NULL ? range->Remap : NULL;
+			glyph.x1 = int(floor(run->SubX + gx * run->ScaleX));
+			glyph.y1 = int(floor(run->SubY + gy * run->ScaleY));
+			glyph.x2 = int(floor(run->SubX + (gx + gw) * run->ScaleX));
+			glyph.y2 = int(floor(run->SubY + (gy + gh) * run->ScaleY));
+			glyph.XStep = pic->GetWidth() / (gw * run->ScaleX);
+			glyph.YStep = pic->GetHeight() / (gh * run->ScaleY);
+			if (glyph.x1 < glyph.x2 && glyph.y1 < glyph.y2)
+			{
+				glyphs.Push (glyph);
+				left = MIN(left, glyph.x1);
+				top = MIN(top, glyph.y1);
+				right = MAX(right, glyph.x2);
+				bottom = MAX(bottom, glyph.y2);
+			}
+		}
+		cx += w + run->Kerning;
+	}
+
+	if (glyphs.Size() == 0)
+	{
+		run->Left = run->Top = run->Width = run->Height = 0;
+		return;
+	}
+
+	run->Left = left;
+	run->Top = top;
+	run->Width = right - left;
+	run->Height = bottom - top;
+	run->Pixels.Resize (run->Width * run->Height);
+
+	TArray<BYTE> opaque(run->Width * run->Height);
+	opaque.Resize (run->Width * run->Height);
+	memset (&opaque[0], 0, opaque.Size());
+
+	int fillcolor = -1;
+	if (run->FillColor != ~0u)
+	{
+		fillcolor = RGB32k[RPART(run->FillColor)>>3][GPART(run->FillColor)>>3][BPART(run->FillColor)>>3];
+	}
+
+	TArray<BYTE> texelOpaque;
+	for (unsigned int i = 0; i < glyphs.Size(); ++i)
+	{
+		const FTextRunGlyph &glyph = glyphs[i];
+		const int texwidth = glyph.Pic->GetWidth();
+		const int texheight = glyph.Pic->GetHeight();
+		texelOpaque.Resize (texheight);
+
+		for (int x = glyph.x1; x < glyph.x2; ++x)
+		{
+			const FTexture::Span *spans;
+			const int column = MIN(int((x - glyph.x1) * glyph.XStep), texwidth - 1);
+			const BYTE *texels = glyph.Pic->GetColumn (column, &spans);
+
+			memset (&texelOpaque[0], 0, texheight);
+			for (; spans->Length != 0; ++spans)
+			{
+				memset (&texelOpaque[spans->TopOffset], 1, spans->Length);
+			}
+
+			for (int y = glyph.y1; y < glyph.y2; ++y)
+			{
+				const int row = MIN(int((y - glyph.y1) * glyph.YStep), texheight - 1);
+				if (!texelOpaque[row])
+					continue;
+
+				const unsigned int dest = (y - top) * run->Width + (x - left);
+				if (fillcolor >= 0)
+					run->Pixels[dest] = fillcolor;
+				else if (glyph.Remap != NULL)
+					run->Pixels[dest] = glyph.Remap[texels[row]];
+				else
+					run->Pixels[dest] = texels[row];
+				opaque[dest] = 1;
+			}
+		}
+	}
+
+	for (int y = 0; y < run->Height; ++y)
+	{
+		const BYTE *line = &opaque[y * run->Width];
+		for (int x = 0; x < run->Width;)
+		{
+			if (!line[x])
+			{
+				++x;
+				continue;
+			}
+
+			FTextRun::Span span;
+			span.x = x;
+			span.y = y;
+			while (x < run->Width && line[x])
+				++x;
+			span.length = x - span.x;
+			run->Spans.Push (span);
+		}
+	}
+}
+
+//==========================================================================
+//
+// FindRun
+//
+//==========================================================================
+
+static FTextRun *FindRun (const FTextRunStyle &style, double subx, double suby, const char *string, size_t len)
+{
+	const unsigned int hash = HashRun (style, subx, suby, string, len);
+	FTextRun **bucket = &RunBuckets[hash % NUM_RUN_BUCKETS];
+
+	for (FTextRun *run = *bucket; run != NULL; run = run->HashNext)
+	{
+		if (RunMatches (run, hash, style, subx, suby, string, len))
+		{
+			UnlinkRecent (run);
+			LinkRecent (run);
+			return run;
+		}
+	}
+
+	FTextRun *run = new FTextRun;
+	run->Font = style.Font;
+	run->Color = style.Color;
+	run->FillColor = style.FillColor;
+	run->ScaleX = style.ScaleX;
+	run->ScaleY = style.ScaleY;
+	run->LineHeight = style.LineHeight;
+	run->Kerning = style.Kerning;
+	run->ColorEscapes = style.ColorEscapes;
+	run->SubX = subx;
+	run->SubY = suby;
+	run->Text = FString(string, len);
+	run->Hash = hash;
+	RasterizeRun (run);
+
+	run->HashNext = *bucket;
+	*bucket = run;
+	LinkRecent (run);
+	++NumRuns;
+	RunBytes += RunSize (run);
+
+	// Never evict the run we're about to draw
+	while (LeastRecentRun != run && (NumRuns > MAX_TEXT_RUNS || RunBytes > MAX_TEXT_RUN_BYTES))
+	{
+		FreeRun (LeastRecentRun);
+	}
+	return run;
+}
+
+//==========================================================================
+//
+// V_DrawTextRun
+//
+//==========================================================================
+
+FTextRunBox V_DrawTextRun (DCanvas *canvas, const FTextRunStyle &style, double x, double y, const char *string, size_t len)
+{
+	const double fx = floor(x), fy = floor(y);
+	const FTextRun *run = FindRun (style, x - fx, y - fy, string, len);
+
+	BYTE *buffer = canvas->GetBuffer();
+	if (buffer == NULL || run->Spans.Size() == 0)
+		return run->Box;
+
+	const int pitch = canvas->GetPitch();
+	const int width = canvas->GetWidth();
+	const int height = canvas->GetHeight();
+	const int ox = int(fx) + run->Left;
+	const int oy = int(fy) + run->Top;
+
+	for (unsigned int i = 0; i < run->Spans.Size(); ++i)
+	{
+		const FTextRun::Span &span = run->Spans[i];
+		const int dy = oy + span.y;
+		if (dy < 0 || dy >= height)
+			continue;
+
+		const BYTE *src = &run->Pixels[span.y * run->Width + span.x];
+		int x1 = ox + span.x;
+		int x2 = x1 + span.length;
+		if (x1 < 0)
+		{
+			src -= x1;
+			x1 = 0;
+		}
+		if (x2 > width)
+			x2 = width;
+		if (x1 < x2)
+			memcpy (buffer + dy * pitch + x1, src, x2 - x1);
+	}
+
+	canvas->MarkDirty (ox, oy, ox + run->Width, oy + run->Height);
+	return run->Box;
+}
+
+//==========================================================================
+//
+// V_ClearTextRuns
+//
+//==========================================================================
+
+void V_ClearTextRuns ()
+{
+	while (MostRecentRun != NULL)
+	{
+		FreeRun (MostRecentRun);
+	}
+}
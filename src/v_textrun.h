@@ -0,0 +1,76 @@
+/*
+** v_textrun.h
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Cache of rasterized text. Drawing a string glyph by glyph goes through
+** the full DrawTexture setup for every character, which adds up for text
+** that is redrawn each frame such as the status bar and menus. Instead
+** each string is rendered once per font, color and scale into a bitmap
+** and copied to the screen from then on.
+**
+*/
+
+#ifndef __V_TEXTRUN_H__
+#define __V_TEXTRUN_H__
+
+#include "v_font.h"
+
+class DCanvas;
+
+// How a string is laid out. The scale is in real pixels per font pixel.
+struct FTextRunStyle
+{
+	FTextRunStyle(FFont *font, EColorRange color, double scalex, double scaley)
+		: Font(font), Color(color), FillColor(~0u), ScaleX(scalex), ScaleY(scaley),
+		LineHeight(font->GetHeight()), Kerning(0), ColorEscapes(false) {}
+
+	FFont *Font;
+	EColorRange Color;
+	uint32 FillColor;	// Draw the glyphs solid in this color like DTA_FillColor, ~0u for none
+	double ScaleX, ScaleY;
+	int LineHeight;		// In font pixels
+	int Kerning;
+	bool ColorEscapes;	// Handle TEXTCOLOR_ESCAPE the way DrawText does
+};
+
+// Area covered by a string in font pixels relative to where it was drawn.
+struct FTextRunBox
+{
+	double x1, y1, x2, y2;
+};
+
+// Draws len characters of string with the origin at real coordinates x, y.
+// The canvas must be locked.
+FTextRunBox V_DrawTextRun (DCanvas *canvas, const FTextRunStyle &style, double x, double y, const char *string, size_t len);
+
+// Frees all cached strings, must be called if a font goes away.
+void V_ClearTextRuns ();
+
+#endif
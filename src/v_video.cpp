@@ -212,6 +212,7 @@ void DCanvas::Dim (PalEntry color, float damount, int x1, int y1, int w, int h)
 	{
 		return;
 	}
+	MarkDirty (x1, y1, x1 + w, y1 + h);
 
 	{
 		int amount;
@@ -417,6 +418,150 @@ DFrameBuffer::DFrameBuffer (int width, int height)
 {
 	LastMS = LastSec = FrameCount = LastCount = LastTic = 0;
 	Accel2D = false;
+
+	NumDirtyRects = 0;
+	AllDirty = true;
+	NumWatchedAreas = 0;
+	WatchedAreaDirty = true;
+}
+
+//==========================================================================
+//
+// DFrameBuffer :: DirtyRect :: Merge
+//
+//==========================================================================
+
+void DFrameBuffer::DirtyRect::Merge (const DirtyRect &other)
+{
+	left = MIN(left, other.left);
+	top = MIN(top, other.top);
+	right = MAX(right, other.right);
+	bottom = MAX(bottom, other.bottom);
+}
+
+//==========================================================================
+//
+// DFrameBuffer :: MarkDirty
+//
+// Records an area that changed since the last Update(). Rects that touch
+// are merged and if we run out of room everything collapses to the
+// bounding box, so the list stays short and cheap to upload.
+//
+//==========================================================================
+
+void DFrameBuffer::MarkDirty (int left, int top, int right, int bottom)
+{
+	DirtyRect rect;
+	rect.left = MAX(left, 0);
+	rect.top = MAX(top, 0);
+	rect.right = MIN(right, Width);
+	rect.bottom = MIN(bottom, Height);
+	if (rect.left >= rect.right || rect.top >= rect.bottom)
+		return;
+
+	if (!WatchedAreaDirty)
+	{
+		for (unsigned i = 0; i < NumWatchedAreas; ++i)
+		{
+			const DirtyRect &area = WatchedAreas[i];
+			if (rect.left < area.right && area.left < rect.right &&
+				rect.top < area.bottom && area.top < rect.bottom)
+			{
+				WatchedAreaDirty = true;
+				break;
+			}
+		}
+	}
+
+	if (AllDirty)
+		return;
+
+	for (unsigned i = 0; i < NumDirtyRects; ++i)
+	{
+		if (DirtyRects[i].Touches(rect))
+		{
+			DirtyRects[i].Merge(rect);
+			return;
+		}
+	}
+
+	if (NumDirtyRects == MAX_DIRTY_RECTS)
+	{
+		for (unsigned i = 0; i < NumDirtyRects; ++i)
+			rect.Merge(DirtyRects[i]);
+		NumDirtyRects = 0;
+	}
+	DirtyRects[NumDirtyRects++] = rect;
+}
+
+//==========================================================================
+//
+// DFrameBuffer :: GetDirtyRects
+//
+//==========================================================================
+
+bool DFrameBuffer::GetDirtyRects (const DirtyRect *&rects, unsigned &numrects) const
+{
+	rects = DirtyRects;
+	numrects = NumDirtyRects;
+	if (AllDirty)
+		return true;
+
+	// Merged rects can overlap, but this is only a heuristic anyway. Past
+	// this point a single upload is cheaper than several locks.
+	int area = 0;
+	for (unsigned i = 0; i < NumDirtyRects; ++i)
+		area += DirtyRects[i].Area();
+	return area >= Width * Height * 3 / 4;
+}
+
+//==========================================================================
+//
+// DFrameBuffer :: ClearDirty
+//
+//==========================================================================
+
+void DFrameBuffer::ClearDirty ()
+{
+	NumDirtyRects = 0;
+	AllDirty = false;
+}
+
+//==========================================================================
+//
+// DFrameBuffer :: ResetWatchedAreas
+//
+//==========================================================================
+
+void DFrameBuffer::ResetWatchedAreas ()
+{
+	NumWatchedAreas = 0;
+	WatchedAreaDirty = false;
+}
+
+//==========================================================================
+//
+// DFrameBuffer :: WatchArea
+//
+// Anything drawn over one of these areas after ResetWatchedAreas() makes
+// IsWatchedAreaDirty() return true.
+//
+//==========================================================================
+
+void DFrameBuffer::WatchArea (int left, int top, int right, int bottom)
+{
+	if (NumWatchedAreas == MAX_WATCHED_AREAS)
+	{
+		// Shouldn't happen, but this way the owner just redraws every time.
+		WatchedAreaDirty = true;
+		return;
+	}
+
+	DirtyRect &area = WatchedAreas[NumWatchedAreas++];
+	area.left = left;
+	area.top = top;
+	area.right = right;
+	area.bottom = bottom;
 }
 
 //==========================================================================
@@ -187,6 +187,10 @@ public:
 	virtual void Unlock () = 0;
 	virtual bool IsLocked () { return Buffer != NULL; }	// Returns true if the surface is locked
 
+	// Notes that pixels in [left,right)x[top,bottom) were drawn to. Only the
+	// frame buffer keeps track of this so it can skip presenting the rest.
+	virtual void MarkDirty (int left, int top, int right, int bottom) {}
+
 	// Draw a linear block of pixels into the canvas
 	virtual void DrawBlock (int x, int y, int width, int height, const BYTE *src) const;
 
@@ -429,14 +433,52 @@ public:
 
 	uint32 GetLastFPS() const { return LastCount; }
 
+	// Dirty rectangle tracking. Update() only needs to convert and upload
+	// what was drawn since the last one, unless everything is marked.
+	void MarkDirty (int left, int top, int right, int bottom);
+	void MarkAllDirty () { AllDirty = true; }
+
+	// Lets 2D elements that repaint themselves only on change (the status
+	// bar) find out if something else drew over them in the meantime.
+	void ResetWatchedAreas ();
+	void WatchArea (int left, int top, int right, int bottom);
+	bool IsWatchedAreaDirty () const { return WatchedAreaDirty; }
+
 	virtual void PaletteChanged () = 0;
 	virtual int QueryNewPalette () = 0;
 	virtual bool Is8BitMode() = 0;
 
 protected:
+	struct DirtyRect
+	{
+		int left, top, right, bottom;
+
+		int Area () const { return (right - left) * (bottom - top); }
+		bool Touches (const DirtyRect &other) const
+		{
+			return left <= other.right && other.left <= right &&
+				top <= other.bottom && other.top <= bottom;
+		}
+		void Merge (const DirtyRect &other);
+	};
+	enum { MAX_DIRTY_RECTS = 16, MAX_WATCHED_AREAS = 8 };
+
 	void DrawRateStuff ();
 	void CopyFromBuff (BYTE *src, int srcPitch, int width, int height, BYTE *dest);
 
+	// Returns true if the whole screen should be updated instead of the
+	// listed rects, because it was all marked or they cover most of it.
+	bool GetDirtyRects (const DirtyRect *&rects, unsigned &numrects) const;
+	void ClearDirty ();
+
+	DirtyRect DirtyRects[MAX_DIRTY_RECTS];
+	unsigned NumDirtyRects;
+	bool AllDirty;
+
+	DirtyRect WatchedAreas[MAX_WATCHED_AREAS];
+	unsigned NumWatchedAreas;
+	bool WatchedAreaDirty;
+
 	DFrameBuffer () {}
 
 private:
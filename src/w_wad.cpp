@@ -49,6 +49,9 @@
 #include "resourcefiles/resourcefile.h"
 #include "zdoomsupport.h"
 #include "filesys.h"
+#ifdef __EMSCRIPTEN__
+#include "emscripten/lazyfile.h"
+#endif
 
 // Work around missing defines for ECWolf
 #ifndef PATH_MAX
@@ -223,6 +226,7 @@ void FWadCollection::AddFile (const char *filename, FileReader *wadinfo)
 {
 	int startlump;
 	bool isdir = false;
+	bool lazy = false;
 
 	if (wadinfo == NULL)
 	{
@@ -240,6 +244,11 @@ void FWadCollection::AddFile (const char *filename, FileReader *wadinfo)
 		{
 			try
 			{
+#ifdef __EMSCRIPTEN__
+				if ((wadinfo = FLazyFileReader::Open(filename)) != NULL)
+					lazy = true;
+				else
+#endif
 				wadinfo = new FileReader(filename);
 			}
 			catch (CRecoverableError &err)
@@ -299,11 +308,71 @@ void FWadCollection::AddFile (const char *filename, FileReader *wadinfo)
 				lump_p->lump = lump;
 				lump_p->wadnum = Files.Size()-1;
 			}
+
+			if (lazy)
+				PrefetchLazyFile(wadinfo, resfile);
 		}
 		return;
 	}
 }
 
+//==========================================================================
+//
+// Archives fetched on demand (see emscripten/lazyfile.cpp) stall the game
+// whenever a part which hasn't been fetched yet is read. The renderer reads
+// from the namespaces textures are created from, which IsTextureLump lists,
+// and from any zip path a texture definition names.
+//
+// Warming those up a lump at a time would cost a round trip per lump, so an
+// archive which is mostly textures is fetched whole up front and kept.
+// Anything else is only streamed, and the textures a level uses are read in
+// by PrecacheLevel while it loads.
+//
+//==========================================================================
+
+static bool IsTextureLump(const FResourceLump *lump)
+{
+	switch (lump->Namespace)
+	{
+		case ns_global:
+			// Wads keep their patches here, in zips it's mostly definitions
+			return !(lump->Flags & LUMPF_ZIPFILE);
+		case ns_sprites:
+		case ns_flats:
+		case ns_newtextures:
+		case ns_patches:
+		case ns_hires:
+		case ns_graphics:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void FWadCollection::PrefetchLazyFile(FileReader *reader, FResourceFile *resfile)
+{
+	size_t total = 0, textures = 0;
+	for (DWORD i = 0; i < resfile->LumpCount(); i++)
+	{
+		FResourceLump *lump = resfile->GetLump(i);
+
+		// Fetching blocks the calling thread.
+		lump->Flags &= ~LUMPF_THREADSAFE;
+
+		total += lump->LumpSize;
+		if (IsTextureLump(lump))
+			textures += lump->LumpSize;
+	}
+
+#ifdef __EMSCRIPTEN__
+	if (textures*2 < total)
+		return;
+
+	// If this fails the missing parts are fetched when first read.
+	static_cast<FLazyFileReader *>(reader)->Preload();
+#endif
+}
+
 //==========================================================================
 //
 // Looks for "vanilla" wolf data embedded into an archive. This is only
@@ -91,6 +91,7 @@ enum ELumpFlags
 	LUMPF_BLOODCRYPT = 8,
 	LUMPF_DONTFLIPFLAT = 16,
 	LUMPF_DOUBLERESFLAT = 32,
+	LUMPF_THREADSAFE = 64,	// Lump may be cached from a thread other than the main one
 };
 
 
@@ -236,6 +237,7 @@ protected:
 	DWORD NumWads;
 
 	void FindEmbeddedWolfData (FResourceFile *res, const char* filename, const char* extension);
+	void PrefetchLazyFile (FileReader *reader, FResourceFile *resfile);
 	void SkinHack (int baselump);
 	void InitHashChains ();								// [RH] Set up the lumpinfo hashing
 
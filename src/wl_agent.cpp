@@ -43,7 +43,6 @@
 
 
 #define MOVESCALE       150l
-#define ANGLESCALE      20
 
 /*
 =============================================================================
@@ -394,12 +393,13 @@ static bool TryMove (AActor *ob)
 				(ob->x-ob->radius) < (x<<TILESHIFT),
 				(ob->y+ob->radius) > ((y+1)<<TILESHIFT)
 			};
-			MapSpot spot = map->GetSpot(x, y, 0);
-			if(spot->tile)
+			const WORD clip = map->GetClip(x, y, 0);
+			if(clip & GameMap::CLIP_Tile)
 			{
 				// Check pushwall backs
-				if(spot->pushAmount != 0)
+				if(clip & GameMap::CLIP_Pushing)
 				{
+					MapSpot spot = map->GetSpot(x, y, 0);
 					switch(spot->pushDirection)
 					{
 						case MapTile::North:
@@ -424,7 +424,7 @@ static bool TryMove (AActor *ob)
 				{
 					for(unsigned short i = 0;i < 4;++i)
 					{
-						if(spot->sideSolid[i] && spot->slideAmount[i] != 0xffff && checkLines[i])
+						if((clip & (GameMap::CLIP_SideSolid<<i)) && !(clip & (GameMap::CLIP_SideOpen<<i)) && checkLines[i])
 							return false;
 					}
 				}
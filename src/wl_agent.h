@@ -46,6 +46,8 @@ void	CreateStatusBar();
 void    CheckWeaponChange (AActor *self);
 void    ControlMovement (class APlayerPawn *self);
 
+#define ANGLESCALE      20	// controlx units per degree of turn
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class AWeapon;
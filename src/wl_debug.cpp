@@ -28,6 +28,7 @@
 #include "wl_iwad.h"
 #include "wl_net.h"
 #include "wl_play.h"
+#include "wl_rewind.h"
 #include "w_wad.h"
 #include "thingdef/thingdef.h"
 #include "g_shared/a_keys.h"
@@ -188,12 +189,14 @@ static int DebugKeys (void)
 	}
 	if (Keyboard[sc_C])             // C = count objects
 	{
-		US_CenterWindow (17,4);
+		US_CenterWindow (20,5);
 
 		FString actorCount;
-		actorCount.Format("\nTotal actors : %d", AActor::actors.Size());
+		actorCount.Format("\nTotal actors : %d\nTextures : %u KiB", AActor::actors.Size(),
+			(unsigned int)(TexMan.GetCacheSize()/1024));
 
 		US_Print (SmallFont, actorCount);
+		TexMan.PrintCacheStats();
 
 		VW_UpdateScreen();
 		IN_Ack (ACK_Block);
@@ -363,6 +366,30 @@ static int DebugKeys (void)
 	}
 	else if (Keyboard[sc_Q])        // Q = fast quit
 		Quit ();
+	else if (Keyboard[sc_R])        // R = rewind
+	{
+		if(Net::InitVars.mode != Net::MODE_SinglePlayer)
+			return 0;
+
+		US_CenterWindow(26,3);
+		PrintY+=6;
+		US_Print(SmallFont, "  Rewind how many seconds: ");
+		VW_UpdateScreen();
+		esc = !US_LineInput (SmallFont,PrintX,py,str,NULL,true,3,WindowX+WindowW-PrintX,GPalette.WhiteIndex);
+		if (!esc && str[0])
+		{
+			if(!Rewind::Restore(atoi(str)*TICRATE))
+			{
+				US_CenterWindow (20,3);
+				US_PrintCentered("No snapshots to rewind to");
+				VW_UpdateScreen();
+				IN_Ack (ACK_Block);
+			}
+			else
+				DrawPlayScreen();
+		}
+		return 1;
+	}
 	else if (Keyboard[sc_S])        // S = slow motion
 	{
 		US_CenterWindow(30,3);
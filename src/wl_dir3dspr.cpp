@@ -7,9 +7,16 @@
 #include "wl_main.h"
 #include "c_cvars.h"
 
-void Scale3DShaper(int x1, int x2, FTexture *shape, uint32_t flags, fixed ny1, fixed ny2,
-				fixed nx1, fixed nx2, byte *vbuf, unsigned vbufPitch)
+void Scale3DShaper(const RenderContext &ctx, int x1, int x2, FTexture *shape, uint32_t flags, fixed ny1, fixed ny2,
+				fixed nx1, fixed nx2)
 {
+	byte* const vbuf = ctx.buf;
+	const unsigned vbufPitch = ctx.pitch;
+	const int viewwidth = ctx.viewwidth;
+	const int viewheight = ctx.viewheight;
+	const fixed scale = ctx.scale;
+	const short centerx = ctx.centerx;
+
 	//printf("%s(%d, %d, %p, %d, %f, %f, %f, %f, %p, %d)\n", __FUNCTION__, x1, x2, shape, flags, FIXED2FLOAT(ny1), FIXED2FLOAT(ny2), FIXED2FLOAT(nx1), FIXED2FLOAT(nx2), vbuf, vbufPitch);
 	fixed dxx=(ny2-ny1)<<8,dzz=(nx2-nx1)<<8;
 	fixed dxa=0,dza=0;
@@ -21,8 +28,8 @@ void Scale3DShaper(int x1, int x2, FTexture *shape, uint32_t flags, fixed ny1, f
 
 	dxa=-(dxx>>1),dza=-(dzz>>1);
 
-	fixed height1 = heightnumerator/((nx1+(dza>>8))>>8);
-	fixed height2 = heightnumerator/((nx1+((dza+dzz)>>8))>>8);
+	fixed height1 = ctx.heightnumerator/((nx1+(dza>>8))>>8);
+	fixed height2 = ctx.heightnumerator/((nx1+((dza+dzz)>>8))>>8);
 	fixed height=(height1<<12)+2048;
 
 	int slinex = (int)((ny1+(dxa>>8))*scale/(nx1+(dza>>8))+centerx);
@@ -61,7 +68,7 @@ void Scale3DShaper(int x1, int x2, FTexture *shape, uint32_t flags, fixed ny1, f
 		{
 			unsigned scale1=(unsigned)(height>>14);
 
-			if(wallheight[slinex]<(height>>12) && scale1)
+			if(ctx.wallheight[slinex]<(height>>12) && scale1)
 			{
 				int pixheight=scale1;
 				int upperedge=(viewheight-pixheight)/2;
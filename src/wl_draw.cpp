@@ -50,8 +50,8 @@
 =============================================================================
 */
 
-void DrawFloorAndCeiling(byte *vbuf, unsigned vbufPitch, int min_wallheight);
-void DrawParallax(byte *vbuf, unsigned vbufPitch);
+void DrawFloorAndCeiling(const RenderContext &ctx);
+void DrawParallax(const RenderContext &ctx);
 
 const RatioInformation AspectCorrection[] =
 {
@@ -65,81 +65,101 @@ const RatioInformation AspectCorrection[] =
 	/* 32:9		*/  {2560, 600, 0x2AAAB, 0,					   48*3/8,     true}
 };
 
-/*static*/ byte *vbuf = NULL;
-unsigned vbufPitch = 0;
-
 int32_t	lasttimecount;
 int32_t	frameon;
 bool	fpscounter;
-int		r_extralight;
 
 int fps_frames=0, fps_time=0, fps=0;
 
-TUniquePtr<int[]> wallheight;
-int min_wallheight;
-
 //
 // math tables
 //
-TUniquePtr<short[]> pixelangle;
 fixed finetangent[FINEANGLES/2 + ANG180];
 fixed finesine[FINEANGLES+FINEANGLES/4];
 fixed *finecosine = finesine+ANG90;
 
-//
-// refresh variables
-//
-fixed   viewx,viewy;                    // the focal point
-angle_t viewangle;
-fixed   viewsin,viewcos;
-int viewshift = 0;
-fixed viewz = 32;
+RenderContext r_mainview;
 
 fixed gLevelVisibility = VISIBILITY_DEFAULT;
 fixed gLevelMaxLightVis = MAXLIGHTVIS_DEFAULT;
 int gLevelLight = LIGHTLEVEL_DEFAULT;
 
-void    TransformActor (AActor *ob);
+void    TransformActor (const RenderContext &ctx, AActor *ob);
 void    BuildTables (void);
 void    ClearScreen (void);
-unsigned int CalcRotate (AActor *ob);
-void    DrawScaleds (void);
+void    DrawScaleds (const RenderContext &ctx);
 void    CalcTics (void);
 void    ThreeDRefresh (void);
 
-
-
-//
-// wall optimization variables
-//
-int     lastside;               // true for vertical
-int32_t    lastintercept;
-MapSpot lasttilehit;
-int     lasttexture;
+#define TEXTUREBASE 0x4000000
 
 //
-// ray tracing variables
+// Casts a ray for each column of the view and draws the walls. All of the
+// intermediate state is kept here so that each view gets a fresh copy.
 //
-short    focaltx,focalty,viewtx,viewty;
-longword xpartialup,xpartialdown,ypartialup,ypartialdown;
-
-short   midangle;
-short   angle;
-
-MapTile::Side hitdir;
-MapSpot tilehit;
-int     pixx;
+class WallCaster
+{
+public:
+	WallCaster(RenderContext &ctx);
+
+	void	AsmRefresh();
+	void	ScalePost();
+
+private:
+	int		CalcHeight();
+	void	DetermineHitDir(bool vertical);
+	void	HitVertWall();
+	void	HitHorizWall();
+
+	RenderContext &ctx;
+
+	//
+	// wall optimization variables
+	//
+	int     lastside;               // true for vertical
+	int32_t    lastintercept;
+	MapSpot lasttilehit;
+	int     lasttexture;
+
+	//
+	// ray tracing variables
+	//
+	short    focaltx,focalty;
+	longword xpartialup,xpartialdown,ypartialup,ypartialdown;
+
+	MapTile::Side hitdir;
+	MapSpot tilehit;
+	int     pixx;
+
+	short   xtile,ytile;
+	short   xtilestep,ytilestep;
+	int32_t    xintercept,yintercept;
+	int     texdelta;
+	int		texheight;
+
+	fixed	texxscale;
+	fixed	texyscale;
+
+	const byte *postsource;
+	int postx;
+};
 
-short   xtile,ytile;
-short   xtilestep,ytilestep;
-int32_t    xintercept,yintercept;
-word    xstep,ystep;
-int     texdelta;
-int		texheight;
+WallCaster::WallCaster(RenderContext &ctx) : ctx(ctx),
+	lastside(-1),                  // the first pixel is on a new wall
+	lastintercept(0), lasttilehit(NULL), lasttexture(0),
+	hitdir(MapTile::East), tilehit(NULL), pixx(0),
+	xtile(0), ytile(0), xtilestep(0), ytilestep(0), xintercept(0), yintercept(0),
+	texdelta(0), texheight(0), texxscale(FRACUNIT), texyscale(FRACUNIT),
+	postsource(NULL), postx(0)
+{
+	focaltx = (short)(ctx.viewx>>TILESHIFT);
+	focalty = (short)(ctx.viewy>>TILESHIFT);
 
-#define TEXTUREBASE 0x4000000
-fixed	texxscale = FRACUNIT;
-fixed	texyscale = FRACUNIT;
+	xpartialdown = ctx.viewx&(TILEGLOBAL-1);
+	xpartialup = TILEGLOBAL-xpartialdown;
+	ypartialdown = ctx.viewy&(TILEGLOBAL-1);
+	ypartialup = TILEGLOBAL-ypartialdown;
+}
 
 
 /*
@@ -158,7 +178,7 @@ fixed	texyscale = FRACUNIT;
 = Takes paramaters:
 =   gx,gy               : globalx/globaly of point
 =
-= globals:
+= context:
 =   viewx,viewy         : point of view
 =   viewcos,viewsin     : sin/cos of viewangle
 =   scale               : conversion from global value to screen value
@@ -173,21 +193,21 @@ fixed	texyscale = FRACUNIT;
 //
 // transform actor
 //
-void TransformActor (AActor *ob)
+void TransformActor (const RenderContext &ctx, AActor *ob)
 {
 	fixed gx,gy,gxt,gyt,nx,ny;
 
 //
 // translate point to view centered coordinates
 //
-	gx = ob->x-viewx;
-	gy = ob->y-viewy;
+	gx = ob->x-ctx.viewx;
+	gy = ob->y-ctx.viewy;
 
 //
 // calculate newx
 //
-	gxt = FixedMul(gx,viewcos);
-	gyt = FixedMul(gy,viewsin);
+	gxt = FixedMul(gx,ctx.viewcos);
+	gyt = FixedMul(gy,ctx.viewsin);
 	// Wolf4SDL used 0x2000 for statics and 0x4000 for moving actors, but since
 	// we no longer tell the difference, use the smaller fudging value since
 	// the larger one will just look ugly in general.
@@ -196,8 +216,8 @@ void TransformActor (AActor *ob)
 //
 // calculate newy
 //
-	gxt = FixedMul(gx,viewsin);
-	gyt = FixedMul(gy,viewcos);
+	gxt = FixedMul(gx,ctx.viewsin);
+	gyt = FixedMul(gy,ctx.viewcos);
 	ny = gyt+gxt;
 
 //
@@ -212,12 +232,12 @@ void TransformActor (AActor *ob)
 		return;
 	}
 
-	ob->viewx = (word)(centerx + ny*scale/nx);
+	ob->viewx = (word)(ctx.centerx + ny*ctx.scale/nx);
 
 //
 // calculate height (heightnumerator/(nx>>8))
 //
-	ob->viewheight = (word)((heightnumerator<<8)/nx);
+	ob->viewheight = (word)((ctx.heightnumerator<<8)/nx);
 }
 
 //==========================================================================
@@ -232,13 +252,13 @@ void TransformActor (AActor *ob)
 ====================
 */
 
-int CalcHeight()
+int WallCaster::CalcHeight()
 {
-	fixed z = FixedMul(xintercept - viewx, viewcos)
-		- FixedMul(yintercept - viewy, viewsin);
+	fixed z = FixedMul(xintercept - ctx.viewx, ctx.viewcos)
+		- FixedMul(yintercept - ctx.viewy, ctx.viewsin);
 	if(z < MINDIST) z = MINDIST;
-	int height = (heightnumerator << 8) / z;
-	if(height < min_wallheight) min_wallheight = height;
+	int height = (ctx.heightnumerator << 8) / z;
+	if(height < ctx.min_wallheight) ctx.min_wallheight = height;
 	return height;
 }
 
@@ -252,10 +272,7 @@ int CalcHeight()
 ===================
 */
 
-const byte *postsource;
-int postx;
-
-void ScalePost()
+void WallCaster::ScalePost()
 {
 	if(postsource == NULL)
 		return;
@@ -263,11 +280,17 @@ void ScalePost()
 	int ywcount, yoffs, yw, yd, yendoffs;
 	byte col;
 
-	const int shade = LIGHT2SHADE(gLevelLight + r_extralight);
-	const int tz = FixedMul(r_depthvisibility<<8, wallheight[postx]);
+	const int viewheight = ctx.viewheight;
+	const int viewshift = ctx.viewshift;
+	const fixed viewz = ctx.viewz;
+	const unsigned vbufPitch = ctx.pitch;
+	byte* const vbuf = ctx.buf;
+
+	const int shade = LIGHT2SHADE(gLevelLight + ctx.extralight);
+	const int tz = FixedMul(ctx.depthvisibility<<8, ctx.wallheight[postx]);
 	BYTE *curshades = &NormalLight.Maps[GETPALOOKUP(MAX(tz, MINZ), shade)<<8];
 
-	ywcount = yd = wallheight[postx];
+	ywcount = yd = ctx.wallheight[postx];
 	if(yd <= 0)
 		yd = 100;
 
@@ -320,14 +343,7 @@ void ScalePost()
 	}
 }
 
-void GlobalScalePost(byte *vidbuf, unsigned pitch)
-{
-	vbuf = vidbuf;
-	vbufPitch = pitch;
-	ScalePost();
-}
-
-static void DetermineHitDir(bool vertical)
+void WallCaster::DetermineHitDir(bool vertical)
 {
 	if(vertical)
 	{
@@ -374,7 +390,7 @@ static int SlideTextureOffset(unsigned int style, int intercept, int amount)
 ====================
 */
 
-void HitVertWall (void)
+void WallCaster::HitVertWall (void)
 {
 	if(!tilehit)
 		return;
@@ -396,7 +412,7 @@ void HitVertWall (void)
 		texture -= texture%texxscale;
 
 		ScalePost();
-		wallheight[pixx] = CalcHeight();
+		ctx.wallheight[pixx] = CalcHeight();
 		if(postsource)
 			postsource+=(texture-lasttexture)*texheight/texxscale;
 		postx=pixx;
@@ -409,7 +425,7 @@ void HitVertWall (void)
 	lastside=1;
 	lastintercept=xtile;
 	lasttilehit=tilehit;
-	wallheight[pixx] = CalcHeight();
+	ctx.wallheight[pixx] = CalcHeight();
 	postx = pixx;
 	FTexture *source = NULL;
 
@@ -421,6 +437,7 @@ void HitVertWall (void)
 
 	if(source)
 	{
+		TexMan.MarkUsed(source);
 		texheight = source->GetHeight();
 		texxscale = TEXTUREBASE/source->xScale;
 		texyscale = source->yScale>>(FRACBITS-8);
@@ -446,7 +463,7 @@ void HitVertWall (void)
 ====================
 */
 
-void HitHorizWall (void)
+void WallCaster::HitHorizWall (void)
 {
 	if(!tilehit)
 		return;
@@ -470,7 +487,7 @@ void HitHorizWall (void)
 		texture -= texture%texxscale;
 
 		ScalePost();
-		wallheight[pixx] = CalcHeight();
+		ctx.wallheight[pixx] = CalcHeight();
 		if(postsource)
 			postsource+=(texture-lasttexture)*texheight/texxscale;
 		postx=pixx;
@@ -483,7 +500,7 @@ void HitHorizWall (void)
 	lastside=0;
 	lastintercept=ytile;
 	lasttilehit=tilehit;
-	wallheight[pixx] = CalcHeight();
+	ctx.wallheight[pixx] = CalcHeight();
 	postx = pixx;
 	FTexture *source = NULL;
 
@@ -495,6 +512,7 @@ void HitHorizWall (void)
 
 	if(source)
 	{
+		TexMan.MarkUsed(source);
 		texheight = source->GetHeight();
 		texxscale = TEXTUREBASE/source->xScale;
 		texyscale = source->yScale>>(FRACBITS-8);
@@ -523,14 +541,14 @@ void HitHorizWall (void)
 =====================
 */
 
-unsigned int CalcRotate (AActor *ob)
+unsigned int CalcRotate (const RenderContext &ctx, AActor *ob)
 {
 	angle_t angle, viewangle;
 
 	// this isn't exactly correct, as it should vary by a trig value,
 	// but it is close enough with only eight rotations
 
-	viewangle = players[ConsolePlayer].camera->angle + (centerx - ob->viewx)/8;
+	viewangle = ctx.camera->angle + (ctx.centerx - ob->viewx)/8;
 
 	angle = viewangle - ob->angle;
 
@@ -562,12 +580,11 @@ typedef struct
 							// you need more than 16-flags for drawing
 } visobj_t;
 
-visobj_t vislist[MAXVISABLE];
-visobj_t *visptr,*visstep,*farthest;
-
-void DrawScaleds (void)
+void DrawScaleds (const RenderContext &ctx)
 {
 	int      i,least,numvisable,height;
+	visobj_t vislist[MAXVISABLE];
+	visobj_t *visptr,*visstep,*farthest = NULL;
 
 	visptr = &vislist[0];
 
@@ -605,7 +622,7 @@ void DrawScaleds (void)
 			|| ( spots[6] && (spots[6]->visible && !spots[6]->tile) )
 			|| ( spots[7] && (spots[7]->visible && !spots[7]->tile) ) )
 		{
-			TransformActor (obj);
+			TransformActor (ctx, obj);
 			if (!obj->viewheight || (gamestate.victoryflag && obj == players[ConsolePlayer].mo))
 				continue;                                               // too close or far away
 
@@ -641,9 +658,9 @@ void DrawScaleds (void)
 		// draw farthest
 		//
 		if(farthest->actor->flags & FL_BILLBOARD)
-			Scale3DSprite(farthest->actor, farthest->actor->state, farthest->viewheight);
+			Scale3DSprite(ctx, farthest->actor, farthest->actor->state, farthest->viewheight);
 		else
-			ScaleSprite(farthest->actor, farthest->actor->viewx, farthest->actor->state, farthest->viewheight);
+			ScaleSprite(ctx, farthest->actor, farthest->actor->viewx, farthest->actor->state, farthest->viewheight);
 
 		farthest->viewheight = 32000;
 	}
@@ -661,7 +678,7 @@ void DrawScaleds (void)
 ==============
 */
 
-void DrawPlayerWeapon (void)
+void DrawPlayerWeapon (const RenderContext &ctx)
 {
 	for(unsigned int i = 0;i < player_t::NUM_PSPRITES;++i)
 	{
@@ -671,23 +688,23 @@ void DrawPlayerWeapon (void)
 		fixed xoffset, yoffset;
 		players[ConsolePlayer].BobWeapon(&xoffset, &yoffset);
 
-		R_DrawPlayerSprite(players[ConsolePlayer].ReadyWeapon, players[ConsolePlayer].psprite[i].frame, players[ConsolePlayer].psprite[i].sx+xoffset, players[ConsolePlayer].psprite[i].sy+yoffset);
+		R_DrawPlayerSprite(ctx, players[ConsolePlayer].ReadyWeapon, players[ConsolePlayer].psprite[i].frame, players[ConsolePlayer].psprite[i].sx+xoffset, players[ConsolePlayer].psprite[i].sy+yoffset);
 	}
 }
 
 //==========================================================================
 
-void AsmRefresh()
+void WallCaster::AsmRefresh()
 {
-	static word xspot[2],yspot[2];
+	word xspot[2],yspot[2];
 	int32_t xstep=0,ystep=0;
 	longword xpartial=0,ypartial=0;
 	MapSpot focalspot = map->GetSpot(focaltx, focalty, 0);
 	bool playerInPushwallBackTile = focalspot->pushAmount != 0;
 
-	for(pixx=0;pixx<viewwidth;pixx++)
+	for(pixx=0;pixx<ctx.viewwidth;pixx++)
 	{
-		short angl=midangle+pixelangle[pixx];
+		short angl=ctx.midangle+ctx.pixelangle[pixx];
 		if(angl<0) angl+=FINEANGLES;
 		if(angl>=ANG360) angl-=FINEANGLES;
 		if(angl<ANG90)
@@ -726,11 +743,11 @@ void AsmRefresh()
 			xpartial=xpartialup;
 			ypartial=ypartialup;
 		}
-		yintercept=FixedMul(ystep,xpartial)+viewy;
+		yintercept=FixedMul(ystep,xpartial)+ctx.viewy;
 		xtile=focaltx+xtilestep;
 		xspot[0]=xtile;
 		xspot[1]=yintercept>>16;
-		xintercept=FixedMul(xstep,ypartial)+viewx;
+		xintercept=FixedMul(xstep,ypartial)+ctx.viewx;
 		ytile=focalty+ytilestep;
 		yspot[0]=xintercept>>16;
 		yspot[1]=ytile;
@@ -1121,47 +1138,50 @@ passhoriz:
 ====================
 */
 
-void WallRefresh (void)
+void WallRefresh (RenderContext &ctx)
 {
-	xpartialdown = viewx&(TILEGLOBAL-1);
-	xpartialup = TILEGLOBAL-xpartialdown;
-	ypartialdown = viewy&(TILEGLOBAL-1);
-	ypartialup = TILEGLOBAL-ypartialdown;
+	ctx.min_wallheight = ctx.viewheight;
+	ctx.viewshift = FixedMul(ctx.focallengthy, finetangent[(ANGLE_180+ctx.camera->pitch)>>ANGLETOFINESHIFT]);
 
-	min_wallheight = viewheight;
-	lastside = -1;                  // the first pixel is on a new wall
-	viewshift = FixedMul(focallengthy, finetangent[(ANGLE_180+players[ConsolePlayer].camera->pitch)>>ANGLETOFINESHIFT]);
 
-	
 	angle_t bobangle = ((gamestate.TimeCount<<13)/(20*TICRATE/35)) & FINEMASK;
 	const fixed playerMovebob = players[ConsolePlayer].mo->GetClass()->Meta.GetMetaFixed(APMETA_MoveBob);
 	fixed curbob = gamestate.victoryflag ? 0 : FixedMul(FixedMul(players[ConsolePlayer].bob, playerMovebob)>>1, finesine[bobangle]);
 
-	viewz = curbob - players[ConsolePlayer].mo->viewheight;
+	ctx.viewz = curbob - players[ConsolePlayer].mo->viewheight;
 
-	AsmRefresh();
-	ScalePost ();                   // no more optimization on last post
+	WallCaster caster(ctx);
+	caster.AsmRefresh();
+	caster.ScalePost ();            // no more optimization on last post
 }
 
-void CalcViewVariables()
+//==========================================================================
+
+RenderContext::RenderContext() : buf(NULL), pitch(0), ratio(ASPECT_4_3),
+	viewwidth(0), viewheight(0), centerx(0), centerxwide(0),
+	focallength(0), focallengthy(0), scale(0), heightnumerator(0),
+	pspritexscale(0), pspriteyscale(0), yaspect(0), depthvisibility(0),
+	min_wallheight(0), camera(NULL), viewx(0), viewy(0), viewz(32),
+	viewangle(0), viewsin(0), viewcos(0), viewshift(0), midangle(0),
+	extralight(0), tablesize(0)
 {
-	viewangle = players[ConsolePlayer].camera->angle;
+}
+
+void RenderContext::SetCamera(AActor *camera, angle_t yawoffset)
+{
+	this->camera = camera;
+
+	viewangle = camera->angle + yawoffset;
 	midangle = viewangle>>ANGLETOFINESHIFT;
 	viewsin = finesine[viewangle>>ANGLETOFINESHIFT];
 	viewcos = finecosine[viewangle>>ANGLETOFINESHIFT];
-	viewx = players[ConsolePlayer].camera->x - FixedMul(focallength,viewcos);
-	viewy = players[ConsolePlayer].camera->y + FixedMul(focallength,viewsin);
+	viewx = camera->x - FixedMul(focallength,viewcos);
+	viewy = camera->y + FixedMul(focallength,viewsin);
 
-	focaltx = (short)(viewx>>TILESHIFT);
-	focalty = (short)(viewy>>TILESHIFT);
-
-	viewtx = (short)(players[ConsolePlayer].camera->x >> TILESHIFT);
-	viewty = (short)(players[ConsolePlayer].camera->y >> TILESHIFT);
-
-	if(players[ConsolePlayer].camera->player)
-		r_extralight = players[ConsolePlayer].camera->player->extralight << 3;
+	if(camera->player)
+		extralight = camera->player->extralight << 3;
 	else
-		r_extralight = 0;
+		extralight = 0;
 }
 
 static TUniquePtr<FFader> fizzlein;
@@ -1189,52 +1209,40 @@ void ThreeDStartFadeIn()
 
 //==========================================================================
 
-void R_RenderView()
+void R_RenderView(RenderContext &ctx)
 {
-	CalcViewVariables();
-
 //
 // follow the walls from there to the right, drawing as we go
 //
 #if 0 // USE_STARSKY
 	if(GetFeatureFlags() & FF_STARSKY)
-		DrawStarSky(vbuf, vbufPitch);
+		DrawStarSky(ctx.buf, ctx.pitch);
 #endif
 
-	WallRefresh ();
+	WallRefresh (ctx);
 
-	DrawParallax(vbuf, vbufPitch);
+	DrawParallax(ctx);
 #if 0 // USE_CLOUDSKY
 	if(GetFeatureFlags() & FF_CLOUDSKY)
-		DrawClouds(vbuf, vbufPitch, min_wallheight);
+		DrawClouds(ctx.buf, ctx.pitch, ctx.min_wallheight);
 #endif
-	DrawFloorAndCeiling(vbuf, vbufPitch, min_wallheight);
+	DrawFloorAndCeiling(ctx);
 
 //
 // draw all the scaled images
 //
-	DrawScaleds();                  // draw scaled stuff
+	DrawScaleds(ctx);               // draw scaled stuff
 
 #if 0 // USE_RAIN
 	if(GetFeatureFlags() & FF_RAIN)
-		DrawRain(vbuf, vbufPitch);
+		DrawRain(ctx.buf, ctx.pitch);
 #endif
 #if 0 // USE_SNOW
 	if(GetFeatureFlags() & FF_SNOW)
-		DrawSnow(vbuf, vbufPitch);
+		DrawSnow(ctx.buf, ctx.pitch);
 #endif
 
-	DrawPlayerWeapon ();    // draw player's hands
-
-	if((control[ConsolePlayer].buttonstate[bt_showstatusbar] || control[ConsolePlayer].buttonheld[bt_showstatusbar]) && viewsize == 21)
-	{
-		ingame = false;
-		StatusBar->DrawStatusBar();
-		ingame = true;
-	}
-
-	// Always mark the current spot as visible in the automap
-	map->GetSpot(players[ConsolePlayer].mo->tilex, players[ConsolePlayer].mo->tiley, 0)->amFlags |= AM_Visible;
+	DrawPlayerWeapon (ctx); // draw player's hands
 }
 
 /*
@@ -1258,16 +1266,28 @@ void    ThreeDRefresh (void)
 //
 	map->ClearVisibility();
 
-	vbuf = VL_LockSurface();
+	byte *vbuf = VL_LockSurface();
 	if(vbuf == NULL) return;
 
-	vbuf += screenofs;
-	vbufPitch = SCREENPITCH;
+	r_mainview.buf = vbuf + screenofs;
+	r_mainview.pitch = SCREENPITCH;
+	r_mainview.SetCamera(players[ConsolePlayer].camera, LateMouseYaw);
+	screen->MarkDirty(viewscreenx, viewscreeny, viewscreenx + viewwidth, viewscreeny + viewheight);
+
+	R_RenderView(r_mainview);
 
-	R_RenderView();
+	if((control[ConsolePlayer].buttonstate[bt_showstatusbar] || control[ConsolePlayer].buttonheld[bt_showstatusbar]) && viewsize == 21)
+	{
+		ingame = false;
+		StatusBar->DrawStatusBar();
+		ingame = true;
+	}
+
+	// Always mark the current spot as visible in the automap
+	map->GetSpot(players[ConsolePlayer].mo->tilex, players[ConsolePlayer].mo->tiley, 0)->amFlags |= AM_Visible;
 
 	VL_UnlockSurface();
-	vbuf = NULL;
+	r_mainview.buf = NULL;
 
 	if(player_t *player = players[ConsolePlayer].camera->player)
 	{
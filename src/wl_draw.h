@@ -1,8 +1,11 @@
 #ifndef __WL_DRAW_H__
 #define __WL_DRAW_H__
 
+#include "c_cvars.h"
 #include "tmemory.h"
 
+class AActor;
+
 /*
 =============================================================================
 
@@ -14,24 +17,70 @@
 //
 // math tables
 //
-extern  TUniquePtr<short[]> pixelangle;
 extern  fixed finetangent[FINEANGLES/2 + ANG180];
 extern	fixed finesine[FINEANGLES+FINEANGLES/4];
 extern	fixed* finecosine;
-extern  TUniquePtr<int[]> wallheight;
 extern  word horizwall[],vertwall[];
 extern  int32_t    frameon;
-extern	int r_extralight;
 
 extern  unsigned screenloc[3];
 
 extern  bool fpscounter;
 
-extern  fixed   viewx,viewy;                    // the focal point
-extern  fixed   viewsin,viewcos;
+//
+// Everything needed to draw one view of the world. The renderer only reads
+// the view it is handed, so save game thumbnails and the like can set up a
+// context of their own and draw into a private buffer without touching the
+// main view.
+//
+struct RenderContext
+{
+	RenderContext();
+
+	void	SetViewSize(unsigned int width, unsigned int height,
+				unsigned int scrWidth, unsigned int scrHeight, Aspect ratio);
+	void	CalcProjection(int32_t focal, float fov);
+	void	CalcVisibility(fixed vis);
+	void	SetCamera(AActor *camera, angle_t yawoffset=0);
+
+	// Destination, viewwidth x viewheight pixels
+	byte		*buf;
+	unsigned	pitch;
+
+	// Projection variables
+	Aspect		ratio;
+	int			viewwidth, viewheight;
+	short		centerx, centerxwide;
+	fixed		focallength, focallengthy;
+	fixed		scale;
+	int32_t		heightnumerator;
+	fixed		pspritexscale, pspriteyscale;
+	fixed		yaspect;
+	fixed		depthvisibility;
+	TUniquePtr<short[]> pixelangle;
+	TUniquePtr<int[]> wallheight;
+	int			min_wallheight;
+
+	// Refresh variables, filled in by SetCamera
+	AActor		*camera;
+	fixed		viewx, viewy;			// the focal point
+	fixed		viewz;
+	angle_t		viewangle;
+	fixed		viewsin, viewcos;
+	int			viewshift;
+	short		midangle;
+	int			extralight;
+
+private:
+	unsigned int tablesize;
+};
+
+// The view of the console player's camera drawn by ThreeDRefresh
+extern	RenderContext r_mainview;
 
 void    ThreeDStartFadeIn ();
 void    ThreeDRefresh (void);
+void    R_RenderView (RenderContext &ctx);
 
 typedef struct
 {
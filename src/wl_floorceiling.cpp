@@ -10,11 +10,17 @@
 
 #include <climits>
 
-extern int viewshift;
-extern fixed viewz;
-
-static void R_DrawPlane(byte *vbuf, unsigned vbufPitch, int min_wallheight, int halfheight, fixed planeheight)
+static void R_DrawPlane(const RenderContext &ctx, int halfheight, fixed planeheight)
 {
+	byte* const vbuf = ctx.buf;
+	const unsigned vbufPitch = ctx.pitch;
+	const int viewwidth = ctx.viewwidth;
+	const int viewheight = ctx.viewheight;
+	const fixed viewx = ctx.viewx;
+	const fixed viewy = ctx.viewy;
+	const fixed viewsin = ctx.viewsin;
+	const fixed viewcos = ctx.viewcos;
+
 	fixed dist;                                // distance to row projection
 	fixed tex_step;                            // global step per one screen pixel
 	fixed gu, gv, du, dv;                      // global texture coordinates
@@ -30,7 +36,7 @@ static void R_DrawPlane(byte *vbuf, unsigned vbufPitch, int min_wallheight, int
 		return;
 
 	const fixed heightFactor = abs(planeheight)>>8;
-	int y0 = ((min_wallheight*heightFactor)>>FRACBITS) - abs(viewshift);
+	int y0 = ((ctx.min_wallheight*heightFactor)>>FRACBITS) - abs(ctx.viewshift);
 	if(y0 > halfheight)
 		return; // view obscured by walls
 	if(y0 <= 0) y0 = 1; // don't let division by zero
@@ -40,7 +46,7 @@ static void R_DrawPlane(byte *vbuf, unsigned vbufPitch, int min_wallheight, int
 	const unsigned int mapwidth = map->GetHeader().width;
 	const unsigned int mapheight = map->GetHeader().height;
 
-	fixed planenumerator = FixedMul(heightnumerator, planeheight);
+	fixed planenumerator = FixedMul(ctx.heightnumerator, planeheight);
 	const bool floor = planenumerator < 0;
 	int tex_offsetPitch;
 	if(floor)
@@ -76,20 +82,20 @@ static void R_DrawPlane(byte *vbuf, unsigned vbufPitch, int min_wallheight, int
 		dist = (planenumerator / (y + 1))<<8;
 		gu =  viewxFrac + FixedMul(dist, viewcos);
 		gv = -viewyFrac + FixedMul(dist, viewsin);
-		tex_step = dist / scale;
+		tex_step = dist / ctx.scale;
 		du =  FixedMul(tex_step, viewsin);
 		dv = -FixedMul(tex_step, viewcos);
 		gu -= (viewwidth >> 1) * du;
 		gv -= (viewwidth >> 1) * dv; // starting point (leftmost)
 
 		// Depth fog
-		const int shade = LIGHT2SHADE(gLevelLight + r_extralight);
-		const int tz = FixedMul(FixedDiv(r_depthvisibility, abs(planeheight)), abs(((halfheight)<<16) - ((halfheight-y)<<16)));
+		const int shade = LIGHT2SHADE(gLevelLight + ctx.extralight);
+		const int tz = FixedMul(FixedDiv(ctx.depthvisibility, abs(planeheight)), abs(((halfheight)<<16) - ((halfheight-y)<<16)));
 		curshades = &NormalLight.Maps[GETPALOOKUP(tz, shade)<<8];
 
 		for(unsigned int x = 0;x < (unsigned)viewwidth; ++x, ++tex_offset)
 		{
-			if(((wallheight[x]*heightFactor)>>FRACBITS) <= y)
+			if(((ctx.wallheight[x]*heightFactor)>>FRACBITS) <= y)
 			{
 				unsigned int curx = viewxTile + (gu >> (TILESHIFT+8));
 				unsigned int cury = viewyTile + (-(gv >> (TILESHIFT+8)) - 1);
@@ -108,6 +114,7 @@ static void R_DrawPlane(byte *vbuf, unsigned vbufPitch, int min_wallheight, int
 						if(curtex.isValid())
 						{
 							FTexture * const texture = TexMan(curtex);
+							TexMan.MarkUsed(texture);
 							tex = texture->GetPixels();
 							texwidth = texture->GetWidth();
 							texheight = texture->GetHeight();
@@ -158,10 +165,10 @@ static void R_DrawPlane(byte *vbuf, unsigned vbufPitch, int min_wallheight, int
 // Textured Floor and Ceiling by DarkOne
 // With multi-textured floors and ceilings stored in lower and upper bytes of
 // according tile in third mapplane, respectively.
-void DrawFloorAndCeiling(byte *vbuf, unsigned vbufPitch, int min_wallheight)
+void DrawFloorAndCeiling(const RenderContext &ctx)
 {
-	const int halfheight = (viewheight >> 1) - viewshift;
+	const int halfheight = (ctx.viewheight >> 1) - ctx.viewshift;
 
-	R_DrawPlane(vbuf, vbufPitch, min_wallheight, halfheight, viewz);
-	R_DrawPlane(vbuf, vbufPitch, min_wallheight, halfheight, viewz+(map->GetPlane(0).depth<<FRACBITS));
+	R_DrawPlane(ctx, halfheight, ctx.viewz);
+	R_DrawPlane(ctx, halfheight, ctx.viewz+(map->GetPlane(0).depth<<FRACBITS));
 }
@@ -17,7 +17,6 @@
 #include "w_wad.h"
 #include "thinker.h"
 #include "actor.h"
-#include <SDL_mixer.h>
 #include "wl_agent.h"
 #include "g_intermission.h"
 #include "g_mapinfo.h"
@@ -27,6 +26,7 @@
 #include "wl_draw.h"
 #include "wl_net.h"
 #include "wl_play.h"
+#include "wl_rewind.h"
 #include "wl_game.h"
 #include "wl_text.h"
 #include "a_inventory.h"
@@ -142,21 +142,21 @@ SetSoundLoc(fixed gx,fixed gy)
 //
 // translate point to view centered coordinates
 //
-	gx -= viewx;
-	gy -= viewy;
+	gx -= r_mainview.viewx;
+	gy -= r_mainview.viewy;
 
 //
 // calculate newx
 //
-	xt = FixedMul(gx,viewcos);
-	yt = FixedMul(gy,viewsin);
+	xt = FixedMul(gx,r_mainview.viewcos);
+	yt = FixedMul(gy,r_mainview.viewsin);
 	x = (xt - yt) >> TILESHIFT;
 
 //
 // calculate newy
 //
-	xt = FixedMul(gx,viewsin);
-	yt = FixedMul(gy,viewcos);
+	xt = FixedMul(gx,r_mainview.viewsin);
+	yt = FixedMul(gy,r_mainview.viewcos);
 	y = (yt + xt) >> TILESHIFT;
 
 	if (y >= ATABLEMAX)
@@ -239,7 +239,7 @@ void UpdateSoundLoc(void)
 {
 	fixed x, y;
 
-	for(int i = 0; i < MIX_CHANNELS; i++)
+	for(unsigned int i = 0; i < DigiMixer::NumVoices; i++)
 	{
 		if(channelSoundPos[i].valid && channelSoundPos[i].positioned)
 		{
@@ -309,6 +309,7 @@ void SetupGameLevel (void)
 	}
 
 	gamestate.faceframe.SetInvalid();
+	Rewind::Clear();
 
 //
 // load the level
@@ -911,6 +912,9 @@ restartgame:
 				if(dointermission)
 					VL_FadeOut(0, 255, RPART(levelInfo->ExitFadeColor), GPART(levelInfo->ExitFadeColor), BPART(levelInfo->ExitFadeColor), levelInfo->ExitFadeDuration);
 
+				// Start loading the next map while the tally is up.
+				CA_PrefetchMap(next);
+
 				StartTravel ();
 				if(dointermission)
 					LevelCompleted ();              // do the intermission
@@ -326,6 +326,10 @@ static void InterWaitForAck()
 {
 	InterState.acked = false;
 	IN_StartAck (ACK_Any);
+
+	// Nothing is animating yet so this is a good time to build the next map.
+	CA_UpdatePrefetch ();
+
 	while (!IN_CheckAck ())
 		BJ_Breathe ();
 	IN_ClearKeysDown();
@@ -65,10 +65,6 @@
 	#include <emscripten.h>
 #endif
 
-void R_RenderView();
-extern byte* vbuf;
-extern unsigned vbufPitch;
-
 namespace GameSave {
 
 unsigned long long SaveVersion = GetSaveVersion();
@@ -522,7 +518,7 @@ void QuickLoadOrSave(bool load)
 	ShowMenu(load ? loadGame : saveGame);
 }
 
-static void Serialize(FArchive &arc)
+void Serialize(FArchive &arc)
 {
 	short difficulty;
 	if(arc.IsStoring())
@@ -631,24 +627,35 @@ void SaveScreenshot(FILE *file)
 	static const int SAVEPICWIDTH = 216;
 	static const int SAVEPICHEIGHT = 162;
 
-	vbuf = new byte[SAVEPICHEIGHT*SAVEPICWIDTH];
-	vbufPitch = SAVEPICWIDTH;
+	TUniquePtr<byte[]> vbuf(new byte[SAVEPICHEIGHT*SAVEPICWIDTH]);
+
+	// Render the thumbnail as its own view so the main view is left alone
+	RenderContext ctx;
+	ctx.buf = vbuf;
+	ctx.pitch = SAVEPICWIDTH;
+	ctx.SetViewSize(SAVEPICWIDTH, SAVEPICHEIGHT, SAVEPICWIDTH, SAVEPICHEIGHT, ASPECT_16_10);
+	ctx.CalcProjection(players[ConsolePlayer].mo->radius, players[ConsolePlayer].FOV);
+	ctx.SetCamera(players[ConsolePlayer].camera);
+	R_RenderView(ctx);
 
-	int oldviewsize = viewsize;
-	Aspect oldaspect = vid_aspect;
+	M_CreatePNG(file, vbuf, GPalette.BaseColors, SS_PAL, SAVEPICWIDTH, SAVEPICHEIGHT, ctx.pitch);
+}
 
-	vid_aspect = ASPECT_16_10;
-	NewViewSize(21, SAVEPICWIDTH, SAVEPICHEIGHT);
-	CalcProjection(players[ConsolePlayer].mo->radius);
-	R_RenderView();
+// Guess how large the uncompressed snapshot will be so that the buffer
+// doesn't need to be repeatedly reallocated while serializing big maps.
+static unsigned int EstimateSnapshotSize()
+{
+	// Roughly the size of a spot with no thinker or triggers attached.
+	static const unsigned int BYTES_PER_SPOT = 48;
+	static const unsigned int BYTES_PER_THINKER = 256;
 
-	M_CreatePNG(file, vbuf, GPalette.BaseColors, SS_PAL, SAVEPICWIDTH, SAVEPICHEIGHT, vbufPitch);
+	const GameMap::Header &header = map->GetHeader();
+	unsigned int size = header.width*header.height*map->NumPlanes()*BYTES_PER_SPOT;
 
-	delete[] vbuf;
-	vbuf = NULL;
+	for(AActor::Iterator iter = AActor::GetIterator();iter.Next();)
+		size += BYTES_PER_THINKER;
 
-	vid_aspect = oldaspect;
-	NewViewSize(oldviewsize); // Restore
+	return size;
 }
 
 bool Save(const FString &filename, const FString &title)
@@ -672,6 +679,7 @@ bool Save(const FString &filename, const FString &title)
 	// If we get hubs this will need to be moved so that we can have multiple of them
 	FCompressedMemFile snapshot;
 	snapshot.Open();
+	snapshot.Reserve(EstimateSnapshotSize());
 	{
 		FArchive arc(snapshot);
 		Serialize(arc);
@@ -35,6 +35,7 @@
 #ifndef __WL_LOADSAVE_H__
 #define __WL_LOADSAVE_H__
 
+class FArchive;
 class FString;
 class Menu;
 class MenuItem;
@@ -54,6 +55,7 @@ namespace GameSave
 
 	bool		Load(const FString &filename);
 	bool		Save(const FString &filename, const FString &title);
+	void		Serialize(FArchive &arc);
 }
 
 #endif
@@ -39,6 +39,9 @@
 #include "wl_game.h"
 #include "wl_loadsave.h"
 #include "wl_net.h"
+#include "wl_netsim.h"
+#include "wl_pacer.h"
+#include "wl_shade.h"
 #include "dobject.h"
 #include "colormatcher.h"
 #include "version.h"
@@ -88,24 +91,14 @@
 */
 
 //
-// proejection variables
+// view window variables
 //
-fixed    focallength;
-fixed    focallengthy;
-fixed    r_depthvisibility;
 unsigned screenofs;
 int      viewscreenx, viewscreeny;
 int      viewwidth;
 int      viewheight;
 int      statusbarx;
 int      statusbary1, statusbary2;
-short    centerx;
-short    centerxwide;
-fixed    scale;
-fixed    pspritexscale;
-fixed    pspriteyscale;
-fixed    yaspect;
-int32_t  heightnumerator;
 
 bool	startgame;
 bool	loadedgame;
@@ -120,6 +113,7 @@ int     panyadjustment;
 bool param_nowait = false;
 int     param_difficulty = 1;           // default is "normal"
 const char* param_tedlevel = NULL;            // default is not to start a level
+const char* param_audiobench = NULL;
 int     param_joystickindex = 0;
 
 int     param_joystickhat = -1;
@@ -245,29 +239,75 @@ void BuildTables (void)
 
 //===========================================================================
 
+void RenderContext::CalcVisibility(fixed vis)
+{
+	depthvisibility = FixedDiv(FixedMul((160*FRACUNIT),vis),focallengthy<<16);
+}
+
 void CalcVisibility(fixed vis)
 {
-	r_depthvisibility = FixedDiv(FixedMul((160*FRACUNIT),vis),focallengthy<<16);
+	r_mainview.CalcVisibility(vis);
+}
+
+/*
+====================
+=
+= RenderContext::SetViewSize
+=
+= Sets up the projection constants which only depend on the size of the view
+= and the screen it is shown on. Must be followed by CalcProjection.
+=
+====================
+*/
+
+void RenderContext::SetViewSize(unsigned int width, unsigned int height,
+	unsigned int scrWidth, unsigned int scrHeight, Aspect ratio)
+{
+	this->ratio = ratio;
+
+	// Some code assumes these are even.
+	viewwidth = width&~1;
+	viewheight = height&~1;
+	centerx = viewwidth/2-1;
+	centerxwide = AspectCorrection[ratio].isWide ? centerx*AspectCorrection[ratio].multiplier/48 : centerx;
+
+	int virtheight = scrHeight;
+	int virtwidth = scrWidth;
+	if(AspectCorrection[ratio].isWide)
+		virtwidth = virtwidth*AspectCorrection[ratio].multiplier/48;
+	else
+		virtheight = virtheight*AspectCorrection[ratio].multiplier/48;
+	yaspect = FixedMul((320<<FRACBITS)/200,(virtheight<<FRACBITS)/virtwidth);
+
+	pspritexscale = (centerxwide<<FRACBITS)/160;
+	pspriteyscale = FixedMul(pspritexscale, yaspect);
+
+	if(tablesize < (unsigned)viewwidth)
+	{
+		tablesize = viewwidth;
+		pixelangle.Reset(new short[tablesize]);
+		wallheight.Reset(new int[tablesize]);
+	}
 }
 
 /*
 ====================
 =
-= CalcProjection
+= RenderContext::CalcProjection
 =
 = Uses focallength
 =
 ====================
 */
 
-void CalcProjection (int32_t focal)
+void RenderContext::CalcProjection (int32_t focal, float fov)
 {
 	int     i;
 	int    intang;
 	int     halfview;
 	double  facedist;
 
-	const fixed projectionFOV = static_cast<fixed>((players[ConsolePlayer].FOV / 90.0f)*AspectCorrection[r_ratio].viewGlobal);
+	const fixed projectionFOV = static_cast<fixed>((fov / 90.0f)*AspectCorrection[ratio].viewGlobal);
 
 	// 0xFD17 is a magic number to convert the player's radius 0x5800 to FOCALLENGTH (0x5700)
 	focallength = FixedMul(focal, 0xFD17);
@@ -300,6 +340,13 @@ void CalcProjection (int32_t focal)
 		pixelangle[halfview-i] = intang;
 		pixelangle[halfview-1+i] = -intang;
 	}
+
+	CalcVisibility(gLevelVisibility);
+}
+
+void CalcProjection (int32_t focal)
+{
+	r_mainview.CalcProjection(focal, players[ConsolePlayer].FOV);
 }
 
 //===========================================================================
@@ -432,6 +479,8 @@ static void InitGame()
 		I_FatalError("Unable to init SDL: %s", SDL_GetError());
 	}
 
+	Pacer::Init();
+
 	SDL_ShowCursor(SDL_DISABLE);
 
 	//
@@ -597,11 +646,10 @@ static void SetViewSize (unsigned int screenWidth, unsigned int screenHeight)
 		height = (statusbary2-statusbary1+1) - (20-viewsize)*8*screenHeight/200;
 	}
 
-	// Some code assumes these are even.
-	viewwidth = width&~1;
-	viewheight = height&~1;
-	centerx = viewwidth/2-1;
-	centerxwide = AspectCorrection[r_ratio].isWide ? CorrectWidthFactor(centerx) : centerx;
+	r_mainview.SetViewSize(width, height, screenWidth, screenHeight, r_ratio);
+
+	viewwidth = r_mainview.viewwidth;
+	viewheight = r_mainview.viewheight;
 	if((unsigned) viewheight == screenHeight)
 		viewscreenx = viewscreeny = screenofs = 0;
 	else
@@ -611,17 +659,6 @@ static void SetViewSize (unsigned int screenWidth, unsigned int screenHeight)
 		screenofs = viewscreeny*SCREENPITCH+viewscreenx;
 	}
 
-	int virtheight = screenHeight;
-	int virtwidth = screenWidth;
-	if(AspectCorrection[r_ratio].isWide)
-		virtwidth = CorrectWidthFactor(virtwidth);
-	else
-		virtheight = CorrectWidthFactor(virtheight);
-	yaspect = FixedMul((320<<FRACBITS)/200,(virtheight<<FRACBITS)/virtwidth);
-
-	pspritexscale = (centerxwide<<FRACBITS)/160;
-	pspriteyscale = FixedMul(pspritexscale, yaspect);
-
 	//
 	// calculate trace angles and projection constants
 	//
@@ -823,6 +860,7 @@ static void DemoLoop()
 			param_tedlevel = NULL;
 			if(GameLoop ())
 				gotoMenu = true;
+			CA_ClearPrefetch();
 
 			if(!param_nowait && !gotoMenu)
 			{
@@ -1119,6 +1157,33 @@ static const char* CheckParameters(int argc, char *argv[], TArray<FString> &file
 				Net::InitVars.joinAddress = argv[i];
 			}
 		}
+		else IFARG("--netdelay")
+		{
+			if(++i < argc)
+				Net::InitVars.inputDelay = atoi(argv[i]);
+		}
+		else IFARG("--netrelay")
+		{
+			Net::InitVars.relay = true;
+		}
+		else IFARG("--netsim")
+		{
+			if(++i >= argc || !NetSim::ParseSettings(argv[i]))
+			{
+				printf("The netsim option expects latency[,jitter[,loss[,reorder]]]!\n");
+				hasError = true;
+			}
+		}
+		else IFARG("--netseed")
+		{
+			if(++i < argc)
+				NetSim::Vars.seed = atoi(argv[i]);
+		}
+		else IFARG("--netbench")
+		{
+			if(++i < argc)
+				NetSim::BenchTics = atoi(argv[i]);
+		}
 		else IFARG("--battle")
 		{
 			Net::InitVars.gameMode = Net::GM_Battle;
@@ -1131,6 +1196,23 @@ static const char* CheckParameters(int argc, char *argv[], TArray<FString> &file
 		{
 			GameSave::param_foreginsave = true;
 		}
+		else IFARG("--mouselatency")
+		{
+			MouseLatencyStats = true;
+		}
+		else IFARG("--framestats")
+		{
+			Pacer::Stats = true;
+		}
+		else IFARG("--audiobench")
+		{
+			if(++i >= argc)
+			{
+				printf("The audiobench option expects a music name and/or sound names!\n");
+				hasError = true;
+			}
+			else param_audiobench = argv[i];
+		}
 		else
 			files.Push(argv[i]);
 	}
@@ -1178,9 +1260,19 @@ static const char* CheckParameters(int argc, char *argv[], TArray<FString> &file
 			" --host <number>        Sets up a network game with the given number of players.\n"
 			" --join <address>       Joins a network game coordinated by the given host.\n"
 			" --port <number>        Port number to use for network communications.\n"
+			" --netdelay <tics>      Input delay used to hide network latency (default: 2)\n"
+			" --netrelay             Relay tic commands through the host (for large games).\n"
+			" --netsim <l,j,p,r>     Simulate l ms latency, j ms jitter, p%% loss\n"
+			"                        and r%% reordering on sent packets.\n"
+			" --netseed <seed>       Random seed for the network simulation.\n"
+			" --netbench <tics>      Print network statistics and quit after the given tics.\n"
 			" --battle               Player vs. player battle\n"
 			" --debugnet             Enable network debugging messages.\n"
 			" --foreignsave          Disable save game validity checking.\n"
+			" --mouselatency         Print how old mouse motion is when it's displayed.\n"
+			" --framestats           Print a histogram of frame times every 5 seconds.\n"
+			" --audiobench <m,s,...> Render music m and sounds s without an audio device,\n"
+			"                        report the emulator and mixer speed and quit.\n"
 			, GetGameCaption(), defaultSampleRate
 		);
 		Quit();
@@ -1320,6 +1412,12 @@ int WL_Main (int argc, char *argv[])
 			language.SetupStrings();
 		}
 
+		if(param_audiobench)
+		{
+			SD_AudioBench(param_audiobench, param_samplerate);
+			Quit();
+		}
+
 		R_InitRenderer();
 
 		printf("InitGame: Setting up the game...\n");
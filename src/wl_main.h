@@ -13,21 +13,11 @@
 */
 
 extern  bool     loadedgame;
-extern  fixed    focallength;
-extern  fixed    focallengthy;
-extern  fixed    r_depthvisibility;
 extern  int      viewscreenx, viewscreeny;
 extern  int      viewwidth;
 extern  int      viewheight;
 extern  int      statusbarx;
 extern  int      statusbary1, statusbary2;
-extern  short    centerx;
-extern  short    centerxwide;
-extern  int32_t  heightnumerator;
-extern  fixed    scale;
-extern  fixed    pspritexscale;
-extern  fixed    pspriteyscale;
-extern  fixed    yaspect;
 extern  int      mousexadjustment;
 extern  int      mouseyadjustment;
 extern  int      panxadjustment;
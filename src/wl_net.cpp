@@ -34,6 +34,10 @@
 
 
 #include "wl_def.h"
+#include "actor.h"
+#include "filesys.h"
+#include "gamemap.h"
+#include "id_ca.h"
 #include "id_in.h"
 #include "id_us.h"
 #include "id_vh.h"
@@ -44,11 +48,15 @@
 #include "wl_menu.h"
 #include "wl_play.h"
 #include "wl_net.h"
+#include "wl_netsim.h"
+#include "wl_pacer.h"
+#include "m_crc32.h"
 #include "m_swap.h"
 #include "m_random.h"
 #include "doomerrors.h"
 #include "zdoomsupport.h"
 #include "zstring.h"
+#include "thingdef/thingdef.h"
 
 #include <SDL.h>
 #include <SDL_net.h>
@@ -56,7 +64,17 @@
 #include <climits>
 
 #define NET_DEFAULT_PORT 5029
-#define MAXEXTRATICS 4
+// Window of tic commands kept for each player. Peers run at most the input
+// delay apart so this only needs to cover that plus however long it takes for
+// a lost packet to be resent.
+#define BACKUPTICS 64
+#define MAXINPUTDELAY 16
+#define MAXTICSPERPACKET 16
+// Stay under the typical MTU.
+#define MAXTICPACKETSIZE 1400
+// How often the play simulation is checked for desyncs.
+#define CONSISTENCYTICS 35
+#define BACKUPCONSISTENCY 4
 
 // TODO: Handle transfer of arbiter status as client quit
 #define Arbiter 0
@@ -123,6 +141,8 @@ struct StartPacket
 	BYTE playerNumber;
 	BYTE numPlayers;
 	BYTE gameMode;
+	BYTE inputDelay;
+	BYTE relay;
 	DWORD rngseed;
 	struct Client
 	{
@@ -172,24 +192,41 @@ struct AckPacket
 	}
 };
 
-struct TicCmdPacket
+// Which buttons are held is implied by the previous tic so only the state is
+// kept, one bit per button.
+struct TicCmd
 {
-	enum { Type = NET_TicCmd };
-
-	BYTE type;
-	int32_t TimeCount;
 	int32_t controlx;
 	int32_t controly;
 	int32_t controlstrafe;
-	BYTE buttonstate[NUMBUTTONS];
-	BYTE buttonheld[NUMBUTTONS];
+	DWORD buttons;
+};
+typedef char TicCmdButtonsFit[NUMBUTTONS <= 32 ? 1 : -1];
+
+// Carries every tic command the recipient hasn't acknowledged yet (up to
+// MAXTICSPERPACKET per player) so that a lost packet is covered by the next
+// one. This is just the header, after it come NumAcks pairs of a player
+// number and the last tic the sender has for that player, then NumSections
+// blocks of a player number, start tic, tic count and the commands.
+// Everything after the header is variable length (see EncodeTicCmd) so the
+// version needs to be bumped whenever that changes.
+struct TicCmdPacket
+{
+	enum { Type = NET_TicCmd, Version = 2 };
+
+	BYTE type;
+	BYTE version;
+	int32_t ConsistencyTic; // Most recent consistency check by the sender
+	DWORD Consistency;
+	int32_t ReportTic; // Tic to write a desync report on, or -1
+	BYTE NumAcks;
+	BYTE NumSections;
 
 	void ByteSwap()
 	{
-		TimeCount = LittleLong(TimeCount);
-		controlx = LittleLong(controlx);
-		controly = LittleLong(controly);
-		controlstrafe = LittleLong(controlstrafe);
+		ConsistencyTic = LittleLong(ConsistencyTic);
+		Consistency = LittleLong(Consistency);
+		ReportTic = LittleLong(ReportTic);
 	}
 };
 
@@ -269,16 +306,36 @@ NetInit InitVars = {
 	GM_Cooperative,
 	NET_DEFAULT_PORT,
 	1,
+	NULL,
+	2,
+	false
 };
 
 struct NetClient
 {
 	IPaddress address;
-	TicCmdPacket extratics[MAXEXTRATICS];
-	unsigned short extrapos;
+	TicCmd tics[BACKUPTICS];
+	int32_t lastTic; // Last tic we have a command for
+	// Last tic of each player's commands this client has received. Only our
+	// own entry is tracked unless we're relaying.
+	int32_t acked[MAXPLAYERS];
+	int32_t consistencyTic;
+	DWORD consistency;
+};
+
+struct ConsistencyCheck
+{
+	int32_t tic;
+	DWORD hash;
 };
 
 static NetClient Client[MAXPLAYERS];
+static int32_t NetTic; // Tic currently being run
+static int32_t RelayedTic; // Last complete tic the arbiter relayed
+static ConsistencyCheck Consistency[BACKUPCONSISTENCY];
+static int32_t ConsistencyTic;
+static int32_t ReportTic;
+static bool DesyncDetected;
 static UDPsocket Socket;
 static UDPpacket *Packet;
 static int32_t PlaysimBlocked = INT_MIN;
@@ -336,7 +393,8 @@ static void DoEndGame()
 	}
 }
 
-// Check if we have a potentially valid packet of a certain type
+// Check if we have a potentially valid packet of a certain type. Packets with
+// a variable length payload are checked against their fixed size header.
 template<typename T>
 static bool CheckPacketType(const UDPpacket *packet)
 {
@@ -359,60 +417,485 @@ static void SendAck(IPaddress address, int32_t TimeCount)
 	ackData.ByteSwap();
 	UDPpacket packet = { -1, (Uint8*)&ackData, sizeof(AckPacket), sizeof(AckPacket), 0, address };
 
-	SDLNet_UDP_Send(Socket, -1, &packet);
+	NetSim::Send(Socket, -1, &packet);
 }
 
-template<typename T>
-bool BufferPacket(int client, const T &packet)
+//==========================================================================
+//
+// Consistency checking
+//
+// Every CONSISTENCYTICS tics each player hashes the parts of the play
+// simulation that are most likely to show a desync and sends it along with
+// its tic commands. If the hashes for a tic differ, every player writes a
+// report of the same state on an agreed upon tic so the reports can be
+// diffed.
+//
+//==========================================================================
+
+static inline DWORD HashInt(DWORD crc, int32_t value)
 {
-	return false;
+	value = LittleLong(value);
+	return AddCRC32(crc, reinterpret_cast<const BYTE *>(&value), sizeof(value));
 }
 
-template<>
-bool BufferPacket<TicCmdPacket>(int client, const TicCmdPacket &packet)
+static DWORD CalcConsistency(FILE *report)
 {
-	if(packet.TimeCount > gamestate.TimeCount)
+	DWORD crc = FRandom::StaticSumSeeds();
+	if(report)
 	{
-		Client[client].extratics[Client[client].extrapos] = packet;
-		Client[client].extrapos = (Client[client].extrapos+1)%MAXEXTRATICS;
+		fprintf(report, "Player %u on tic %d (time count %d) of %s\n\n", ConsolePlayer, NetTic, gamestate.TimeCount, gamestate.mapname);
+		fprintf(report, "RNG:\n");
+		FRandom::StaticPrintSeeds(report);
+		fprintf(report, "\nActors:\n");
 	}
-	return true;
+
+	unsigned int num = 0;
+	for(AActor::Iterator iter = AActor::GetIterator();iter.Next();++num)
+	{
+		AActor *actor = iter;
+		const char *className = actor->GetClass()->GetName().GetChars();
+		const Frame *state = actor->state;
+
+		crc = AddCRC32(crc, reinterpret_cast<const BYTE *>(className), (unsigned int)strlen(className));
+		crc = HashInt(crc, actor->x);
+		crc = HashInt(crc, actor->y);
+		crc = HashInt(crc, actor->z);
+		crc = HashInt(crc, actor->velx);
+		crc = HashInt(crc, actor->vely);
+		crc = HashInt(crc, actor->angle);
+		crc = HashInt(crc, actor->health);
+		crc = HashInt(crc, state ? state->index : -1);
+		crc = HashInt(crc, actor->ticcount);
+
+		if(report)
+		{
+			fprintf(report, "%4u %-24s x=%08X y=%08X z=%08X vel=%08X,%08X angle=%08X health=%d state=%.4s%c:%d tics=%d\n",
+				num, className, actor->x, actor->y, actor->z, actor->velx, actor->vely,
+				actor->angle, actor->health, state ? state->sprite : "----",
+				state ? 'A'+state->frame : '-', state ? (int)state->index : -1,
+				actor->ticcount);
+		}
+	}
+
+	// Doors and pushwalls
+	if(report)
+		fprintf(report, "\nMap:\n");
+	for(unsigned int p = 0;map && p < map->NumPlanes();++p)
+	{
+		const GameMap::Plane &plane = map->GetPlane(p);
+		const unsigned int size = map->GetHeader().width*map->GetHeader().height;
+		for(unsigned int i = 0;i < size;++i)
+		{
+			const MapSpot spot = &plane.map[i];
+			if(!spot->thinker && !spot->pushAmount &&
+				!(spot->slideAmount[0]|spot->slideAmount[1]|spot->slideAmount[2]|spot->slideAmount[3]))
+				continue;
+
+			crc = HashInt(crc, i);
+			crc = HashInt(crc, map->GetTileIndex(spot->tile));
+			for(unsigned int side = 0;side < 4;++side)
+				crc = HashInt(crc, spot->slideAmount[side]);
+			crc = HashInt(crc, spot->pushDirection);
+			crc = HashInt(crc, spot->pushAmount);
+
+			if(report)
+			{
+				fprintf(report, "%u,%u,%u tile=%d slide=%u,%u,%u,%u push=%d:%u%s\n",
+					spot->GetX(), spot->GetY(), p, (int)map->GetTileIndex(spot->tile),
+					spot->slideAmount[0], spot->slideAmount[1], spot->slideAmount[2], spot->slideAmount[3],
+					spot->pushDirection, spot->pushAmount, spot->thinker ? " active" : "");
+			}
+		}
+	}
+
+	if(report)
+		fprintf(report, "\nConsistency: %08X\n", crc);
+	return crc;
 }
 
-template<typename T>
-int UnbufferPacket(T (&packets)[MAXPLAYERS], bool (&received)[MAXPLAYERS])
+static void WriteDesyncReport()
+{
+	FString fname;
+	fname.Format("%s" PATH_SEPARATOR "desync-%u-%d.txt",
+		FileSys::GetDirectoryPath(FileSys::DIR_Configuration).GetChars(), ConsolePlayer, NetTic);
+
+	FILE *file = File(fname).open("w");
+	if(!file)
+	{
+		Printf("Could not write desync report %s\n", fname.GetChars());
+		return;
+	}
+	CalcConsistency(file);
+	fclose(file);
+	Printf("Wrote desync report %s\n", fname.GetChars());
+}
+
+static void CheckConsistency(unsigned int client)
+{
+	if(DesyncDetected)
+		return;
+
+	const ConsistencyCheck &local = Consistency[(Client[client].consistencyTic/CONSISTENCYTICS)%BACKUPCONSISTENCY];
+	if(local.tic != Client[client].consistencyTic || local.hash == Client[client].consistency)
+		return;
+
+	Printf("Desync: Player %u is out of sync as of tic %d\n", client+1, local.tic);
+	DesyncDetected = true;
+	NetSim::RecordDesync();
+
+	// Pick a tic which nobody could have run yet since they need our
+	// commands to proceed past what we've already sent.
+	if(ReportTic < NetTic)
+		ReportTic = Client[ConsolePlayer].lastTic + 2;
+}
+
+static void UpdateConsistency()
+{
+	if(NetTic == ReportTic)
+		WriteDesyncReport();
+
+	if(NetTic == 0 || NetTic%CONSISTENCYTICS != 0 || ConsistencyTic == NetTic)
+		return;
+
+	ConsistencyCheck &check = Consistency[(NetTic/CONSISTENCYTICS)%BACKUPCONSISTENCY];
+	check.tic = ConsistencyTic = NetTic;
+	check.hash = CalcConsistency(NULL);
+
+	for(unsigned int i = 0;i < InitVars.numPlayers;++i)
+	{
+		if(i != ConsolePlayer)
+			CheckConsistency(i);
+	}
+}
+
+//==========================================================================
+//
+// Tic command encoding
+//
+// Each command starts with a byte of flags indicating which fields differ
+// from the previous command in the packet (the first is compared against an
+// empty command) followed by the changes as variable length integers. Axes
+// are sent as zigzag encoded differences so that small changes in either
+// direction are a single byte, and buttons as the bits which toggled.
+//
+//==========================================================================
+
+enum
+{
+	TCF_ControlX = 0x1,
+	TCF_ControlY = 0x2,
+	TCF_ControlStrafe = 0x4,
+	TCF_Buttons = 0x8
+};
+#define MAXTICCMDSIZE (1 + 4*5)
+
+static inline DWORD ZigZag(int32_t value)
+{
+	return (static_cast<DWORD>(value)<<1) ^ static_cast<DWORD>(value>>31);
+}
+
+static inline int32_t UnZigZag(DWORD value)
+{
+	return static_cast<int32_t>(value>>1) ^ -static_cast<int32_t>(value&1);
+}
+
+static BYTE *WriteVarInt(BYTE *out, DWORD value)
+{
+	while(value >= 0x80)
+	{
+		*out++ = static_cast<BYTE>(value|0x80);
+		value >>= 7;
+	}
+	*out++ = static_cast<BYTE>(value);
+	return out;
+}
+
+// Returns NULL if the value runs off the end of the data.
+static const BYTE *ReadVarInt(const BYTE *in, const BYTE *end, DWORD &value)
+{
+	value = 0;
+	for(unsigned int shift = 0;shift < 32 && in < end;shift += 7)
+	{
+		const BYTE b = *in++;
+		value |= static_cast<DWORD>(b&0x7F)<<shift;
+		if(!(b&0x80))
+			return in;
+	}
+	return NULL;
+}
+
+static BYTE *EncodeTicCmd(BYTE *out, const TicCmd &cmd, const TicCmd &prev)
 {
-	return 0;
+	BYTE &flags = *out++;
+	flags = 0;
+
+	if(cmd.controlx != prev.controlx)
+	{
+		flags |= TCF_ControlX;
+		out = WriteVarInt(out, ZigZag(cmd.controlx - prev.controlx));
+	}
+	if(cmd.controly != prev.controly)
+	{
+		flags |= TCF_ControlY;
+		out = WriteVarInt(out, ZigZag(cmd.controly - prev.controly));
+	}
+	if(cmd.controlstrafe != prev.controlstrafe)
+	{
+		flags |= TCF_ControlStrafe;
+		out = WriteVarInt(out, ZigZag(cmd.controlstrafe - prev.controlstrafe));
+	}
+	if(cmd.buttons != prev.buttons)
+	{
+		flags |= TCF_Buttons;
+		out = WriteVarInt(out, cmd.buttons ^ prev.buttons);
+	}
+	return out;
+}
+
+static const BYTE *DecodeTicCmd(const BYTE *in, const BYTE *end, TicCmd &cmd, const TicCmd &prev)
+{
+	if(in >= end)
+		return NULL;
+
+	const BYTE flags = *in++;
+	DWORD value;
+
+	cmd = prev;
+	if(flags & TCF_ControlX)
+	{
+		if(!(in = ReadVarInt(in, end, value)))
+			return NULL;
+		cmd.controlx += UnZigZag(value);
+	}
+	if(flags & TCF_ControlY)
+	{
+		if(!(in = ReadVarInt(in, end, value)))
+			return NULL;
+		cmd.controly += UnZigZag(value);
+	}
+	if(flags & TCF_ControlStrafe)
+	{
+		if(!(in = ReadVarInt(in, end, value)))
+			return NULL;
+		cmd.controlstrafe += UnZigZag(value);
+	}
+	if(flags & TCF_Buttons)
+	{
+		if(!(in = ReadVarInt(in, end, value)))
+			return NULL;
+		cmd.buttons ^= value;
+	}
+	return in;
+}
+
+// Stores the tic commands from a packet which follow what we already have.
+static void ReceiveTics(int client, const TicCmdPacket &data, const BYTE *payload, int len)
+{
+	if(data.version != TicCmdPacket::Version)
+	{
+		Printf("Tic commands from player %d are version %d, expected %d\n", client+1, data.version, TicCmdPacket::Version);
+		return;
+	}
+
+	NetClient &cl = Client[client];
+	if(data.ReportTic >= NetTic && ReportTic < NetTic)
+		ReportTic = data.ReportTic;
+	if(data.ConsistencyTic > cl.consistencyTic)
+	{
+		cl.consistencyTic = data.ConsistencyTic;
+		cl.consistency = data.Consistency;
+		CheckConsistency(client);
+	}
+
+	const BYTE *in = payload;
+	const BYTE *end = payload + len;
+	DWORD value;
+
+	for(BYTE i = 0;i < data.NumAcks;++i)
+	{
+		if(in >= end)
+			goto malformed;
+		const BYTE player = *in++;
+		if(!(in = ReadVarInt(in, end, value)))
+			goto malformed;
+
+		if(player < InitVars.numPlayers)
+		{
+			const int32_t tic = static_cast<int32_t>(value)-1;
+			if(tic > cl.acked[player])
+				cl.acked[player] = MIN(tic, Client[player].lastTic);
+		}
+	}
+
+	for(BYTE section = 0;section < data.NumSections;++section)
+	{
+		if(in + 1 >= end)
+			goto malformed;
+		const BYTE player = *in++;
+		if(!(in = ReadVarInt(in, end, value)) || in >= end)
+			goto malformed;
+		const int32_t startTic = static_cast<int32_t>(value);
+		const BYTE numTics = *in++;
+
+		// Only the arbiter may send commands on behalf of other players.
+		if(player >= InitVars.numPlayers || player == ConsolePlayer ||
+			(player != client && !(InitVars.relay && client == Arbiter)) ||
+			numTics > MAXTICSPERPACKET)
+			goto malformed;
+
+		NetClient &owner = Client[player];
+		TicCmd cmd = {0, 0, 0, 0};
+		for(BYTE i = 0;i < numTics;++i)
+		{
+			if(!(in = DecodeTicCmd(in, end, cmd, cmd)))
+				goto malformed;
+
+			const int32_t tic = startTic + i;
+			// Don't overwrite tics that haven't been run yet, or the one
+			// before the current tic since that's needed for the held buttons.
+			if(tic != owner.lastTic+1 || tic - NetTic >= BACKUPTICS-1)
+				continue;
+
+			owner.tics[tic%BACKUPTICS] = cmd;
+			owner.lastTic = tic;
+		}
+	}
+	return;
+
+malformed:
+	Printf("Malformed tic commands from player %d\n", client+1);
 }
 
-template<>
-int UnbufferPacket<TicCmdPacket>(TicCmdPacket (&packets)[MAXPLAYERS], bool (&received)[MAXPLAYERS])
+// Sends all of the tic commands the recipients haven't acknowledged. Normally
+// that's just our own commands to every player, but when relaying the other
+// players only talk to the arbiter which forwards everyone's commands.
+static void SendTics()
 {
-	int unbufferedCount = 0;
-	for(unsigned int i = 0;i < MAXEXTRATICS;++i)
+	BYTE buffer[MAXTICPACKETSIZE];
+	TicCmdPacket data;
+	const bool relaying = InitVars.relay && IsArbiter();
+
+	for(unsigned int i = 0;i < InitVars.numPlayers;++i)
 	{
-		for(unsigned int c = 0;c < InitVars.numPlayers;++c)
+		if(i == ConsolePlayer || (InitVars.relay && !relaying && i != Arbiter))
+			continue;
+
+		NetClient &recipient = Client[i];
+		BYTE *out = buffer + sizeof(TicCmdPacket);
+
+		data.type = TicCmdPacket::Type;
+		data.version = TicCmdPacket::Version;
+		data.ConsistencyTic = ConsistencyTic;
+		data.Consistency = Consistency[(ConsistencyTic/CONSISTENCYTICS)%BACKUPCONSISTENCY].hash;
+		data.ReportTic = ReportTic;
+		data.NumAcks = 0;
+		data.NumSections = 0;
+		data.ByteSwap();
+
+		// The arbiter gets everything from a relayed client so it needs to
+		// know how far along we are with everyone.
+		for(unsigned int p = 0;p < InitVars.numPlayers;++p)
 		{
-			if(c == ConsolePlayer)
+			if(p == ConsolePlayer || (p != i && !(InitVars.relay && i == Arbiter)))
+				continue;
+
+			*out++ = static_cast<BYTE>(p);
+			out = WriteVarInt(out, static_cast<DWORD>(Client[p].lastTic+1));
+			++data.NumAcks;
+		}
+
+		for(unsigned int p = 0;p < InitVars.numPlayers;++p)
+		{
+			if(p == i || (p != ConsolePlayer && !relaying))
+				continue;
+
+			const NetClient &owner = Client[p];
+			const int32_t start = MAX(recipient.acked[p]+1, owner.lastTic-BACKUPTICS+2);
+			if(start > owner.lastTic || buffer + sizeof(buffer) - out < 7 + MAXTICCMDSIZE)
 				continue;
 
-			if(Client[c].extratics[i].TimeCount != 0 && Client[c].extratics[i].TimeCount == gamestate.TimeCount)
+			*out++ = static_cast<BYTE>(p);
+			out = WriteVarInt(out, static_cast<DWORD>(start));
+			BYTE &numTics = *out++;
+			numTics = 0;
+			++data.NumSections;
+
+			static const TicCmd empty = {0, 0, 0, 0};
+			const TicCmd *prev = &empty;
+			for(int32_t tic = start;tic <= owner.lastTic && numTics < MAXTICSPERPACKET;++tic)
 			{
-				packets[c] = Client[c].extratics[i];
-				Client[c].extratics[i].TimeCount = 0;
-				if(received[c])
-					continue;
-				received[c] = true;
-				++unbufferedCount;
+				if(buffer + sizeof(buffer) - out < MAXTICCMDSIZE)
+					break;
+
+				const TicCmd &cmd = owner.tics[tic%BACKUPTICS];
+				out = EncodeTicCmd(out, cmd, *prev);
+				prev = &cmd;
+				++numTics;
 			}
 		}
+
+		memcpy(buffer, &data, sizeof(TicCmdPacket));
+
+		const int size = static_cast<int>(out - buffer);
+		UDPpacket packet = { -1, buffer, size, size, 0, recipient.address };
+		NetSim::Send(Socket, -1, &packet);
+	}
+}
+
+// When relaying, the arbiter forwards commands once per tic as soon as it has
+// everyone's commands for it.
+static void RelayTics()
+{
+	if(!InitVars.relay || !IsArbiter())
+		return;
+
+	int32_t complete = INT_MAX;
+	for(unsigned int i = 0;i < InitVars.numPlayers;++i)
+		complete = MIN(complete, Client[i].lastTic);
+
+	if(complete > RelayedTic)
+	{
+		RelayedTic = complete;
+		SendTics();
 	}
-	return unbufferedCount;
+}
+
+// All players start out with neutral commands for the first tics, covering
+// the time it takes for the first real commands to take effect.
+static void ResetTics()
+{
+	NetTic = 0;
+	for(unsigned int i = 0;i < InitVars.numPlayers;++i)
+	{
+		memset(Client[i].tics, 0, sizeof(Client[i].tics));
+		Client[i].lastTic = InitVars.inputDelay-1;
+		for(unsigned int p = 0;p < MAXPLAYERS;++p)
+			Client[i].acked[p] = InitVars.inputDelay-1;
+		Client[i].consistencyTic = 0;
+	}
+	RelayedTic = InitVars.inputDelay-1;
+
+	memset(Consistency, 0, sizeof(Consistency));
+	ConsistencyTic = 0;
+	ReportTic = -1;
+	DesyncDetected = false;
 }
 
 static void HandleCommandPackets()
 {
-	if(CheckPacketType<BlockPlaysimPacket>(Packet))
+	if(CheckPacketType<TicCmdPacket>(Packet))
+	{
+		int client = FindClient(Packet->address);
+		if(client < 0)
+		{
+			Printf("Packet recieved from unknown source\n");
+			return;
+		}
+
+		ReceiveTics(client, *reinterpret_cast<TicCmdPacket *>(Packet->data),
+			Packet->data + sizeof(TicCmdPacket), Packet->len - sizeof(TicCmdPacket));
+	}
+	else if(CheckPacketType<BlockPlaysimPacket>(Packet))
 	{
 		const BlockPlaysimPacket *data = reinterpret_cast<BlockPlaysimPacket *>(Packet->data);
 
@@ -481,8 +964,6 @@ static void ExchangePacket(T (&packets)[MAXPLAYERS])
 	acked[ConsolePlayer] = true;
 	received[ConsolePlayer] = true;
 
-	numReceived += UnbufferPacket(packets, received);
-
 	UDPpacket outPacket = { -1, (Uint8*)&packets[ConsolePlayer], sizeof(T), sizeof(T), 0 };
 	packets[ConsolePlayer].type = T::Type;
 	packets[ConsolePlayer].TimeCount = gamestate.TimeCount;
@@ -502,7 +983,7 @@ static void ExchangePacket(T (&packets)[MAXPLAYERS])
 					continue;
 
 				outPacket.address = Client[i].address;
-				SDLNet_UDP_Send(Socket, -1, &outPacket);
+				NetSim::Send(Socket, -1, &outPacket);
 			}
 			resend = 100;
 		}
@@ -517,10 +998,10 @@ static void ExchangePacket(T (&packets)[MAXPLAYERS])
 			// Allow user to enter control panels even if we're waiting for data
 			if(ingame)
 				CheckKeys();
-			SDL_Delay(1);
+			Pacer::Idle();
 		}
 
-		while(SDLNet_UDP_Recv(Socket, Packet))
+		while(NetSim::Recv(Socket, Packet))
 		{
 			if(CheckPacketType<T>(Packet))
 			{
@@ -534,11 +1015,7 @@ static void ExchangePacket(T (&packets)[MAXPLAYERS])
 				T &data = *reinterpret_cast<T *>(Packet->data);
 
 				if(data.TimeCount != gamestate.TimeCount)
-				{
-					if(BufferPacket<T>(client, data))
-						SendAck<T>(Packet->address, data.TimeCount);
 					continue;
-				}
 
 				SendAck<T>(Packet->address, data.TimeCount);
 
@@ -571,10 +1048,6 @@ static void ExchangePacket(T (&packets)[MAXPLAYERS])
 				HandleCommandPackets();
 			}
 		}
-
-		// If a debug command changes the play state then we should abort
-		if((int)T::Type == NET_TicCmd && playstate != ex_stillplaying)
-			break;
 	}
 }
 
@@ -605,7 +1078,7 @@ static void SendReliablePacket(T &packet)
 					continue;
 
 				outPacket.address = Client[i].address;
-				SDLNet_UDP_Send(Socket, -1, &outPacket);
+				NetSim::Send(Socket, -1, &outPacket);
 			}
 			resend = 100;
 		}
@@ -622,10 +1095,10 @@ static void SendReliablePacket(T &packet)
 			// Allow user to enter control panels even if we're waiting for data
 			if(ingame && T::Type != (int)NET_BlockPlaysim)
 				CheckKeys();
-			SDL_Delay(1);
+			Pacer::Idle();
 		}
 
-		while(SDLNet_UDP_Recv(Socket, Packet))
+		while(NetSim::Recv(Socket, Packet))
 		{
 			if(CheckPacketType<AckPacket>(Packet))
 			{
@@ -671,7 +1144,7 @@ static void StartHost(InitStatusCallback callback)
 		Printf("\b\b\b%s", Waiting[waitpos]);
 		fflush(stdout);
 
-		if(SDLNet_UDP_Recv(Socket, Packet))
+		if(NetSim::Recv(Socket, Packet))
 		{
 			const RequestPacket *data = reinterpret_cast<RequestPacket*>(Packet->data);
 			if(CheckPacketType<RequestPacket>(Packet))
@@ -707,6 +1180,8 @@ static void StartHost(InitStatusCallback callback)
 	startData->type = StartPacket::Type;
 	startData->numPlayers = InitVars.numPlayers;
 	startData->gameMode = InitVars.gameMode;
+	startData->inputDelay = InitVars.inputDelay;
+	startData->relay = InitVars.relay;
 	startData->rngseed = rngseed;
 	for(unsigned int i = 1;i < InitVars.numPlayers;++i)
 	{
@@ -727,14 +1202,14 @@ static void StartHost(InitStatusCallback callback)
 			startPacket.address = Client[i].address;
 			startData->playerNumber = i;
 
-			SDLNet_UDP_Send(Socket, -1, &startPacket);
+			NetSim::Send(Socket, -1, &startPacket);
 		}
 
 		SDL_Delay(100);
 		IN_ProcessEvents();
 
 		// Look for ack packets
-		while(SDLNet_UDP_Recv(Socket, Packet))
+		while(NetSim::Recv(Socket, Packet))
 		{
 			const AckPacket *data = reinterpret_cast<AckPacket*>(Packet->data);
 			if(CheckPacketType<AckPacket>(Packet))
@@ -789,11 +1264,11 @@ static void StartJoin(InitStatusCallback callback)
 		// Send request periodically as a heart beat
 		if(waitpos == 0)
 		{
-			SDLNet_UDP_Send(Socket, -1, &packet);
+			NetSim::Send(Socket, -1, &packet);
 		}
 
 		// Look for start sync packets
-		if(SDLNet_UDP_Recv(Socket, Packet))
+		if(NetSim::Recv(Socket, Packet))
 		{
 			const StartPacket *data = reinterpret_cast<StartPacket *>(Packet->data);
 			if(CheckPacketType<StartPacket>(Packet))
@@ -801,6 +1276,8 @@ static void StartJoin(InitStatusCallback callback)
 				ConsolePlayer = data->playerNumber;
 				InitVars.numPlayers = data->numPlayers;
 				InitVars.gameMode = static_cast<GameMode>(data->gameMode);
+				InitVars.inputDelay = data->inputDelay;
+				InitVars.relay = data->relay != 0;
 				rngseed = data->rngseed;
 
 				Client[0].address = Packet->address;
@@ -828,6 +1305,10 @@ static void StartJoin(InitStatusCallback callback)
 
 static void Shutdown()
 {
+	if(NetSim::Enabled || NetSim::BenchTics)
+		NetSim::PrintStats();
+	NetSim::Clear();
+
 	SDLNet_FreePacket(Packet);
 	SDLNet_UDP_Close(Socket);
 }
@@ -838,6 +1319,8 @@ void Init(InitStatusCallback callback)
 	if(InitVars.mode == MODE_SinglePlayer)
 		return;
 
+	InitVars.inputDelay = MIN<byte>(InitVars.inputDelay, MAXINPUTDELAY);
+
 	if(SDLNet_Init() < 0)
 	{
 		I_FatalError("Unable to init SDL_net: %s", SDLNet_GetError());
@@ -933,41 +1416,105 @@ void NewGame(int &difficulty, FString &map, FName (&playerClassNames)[MAXPLAYERS
 			map = newGamePackets[client].map;
 		}
 	}
+
+	ResetTics();
 }
 
 void PollControls()
 {
-	TicCmdPacket ticcmdPackets[MAXPLAYERS];
-	bool controls[MAXPLAYERS] = { false };
-
-	// We need to send a ticcmd to each player in the game.
-	TicCmdPacket &ticcmdData = ticcmdPackets[ConsolePlayer];
-	ticcmdData.controlx = control[ConsolePlayer].controlx;
-	ticcmdData.controly = control[ConsolePlayer].controly;
-	ticcmdData.controlstrafe = control[ConsolePlayer].controlstrafe;
-	assert(sizeof(control[ConsolePlayer].buttonstate) == sizeof(ticcmdData.buttonstate));
-	memcpy(ticcmdData.buttonstate, control[ConsolePlayer].buttonstate, sizeof(control[ConsolePlayer].buttonstate));
-	memcpy(ticcmdData.buttonheld, control[ConsolePlayer].buttonheld, sizeof(control[ConsolePlayer].buttonheld));
-
-	ExchangePacket(ticcmdPackets);
-	// Undo the byte swapping of our own packet that ExchangePacket does
-	ticcmdData.ByteSwap();
-
-	if(playstate != ex_stillplaying)
-		return;
+	NetClient &self = Client[ConsolePlayer];
 
-	for(unsigned int client = 0;client < InitVars.numPlayers;++client)
+	UpdateConsistency();
+
+	// Queue up our command to be run once the input delay has passed. If we
+	// were interrupted while waiting on the last call then it's already been
+	// sent so don't replace it.
+	const int32_t localTic = NetTic + InitVars.inputDelay;
+	if(self.lastTic < localTic)
 	{
-		if(client == ConsolePlayer)
-			continue;
+		TicCmd &cmd = self.tics[localTic%BACKUPTICS];
+		cmd.controlx = control[ConsolePlayer].controlx;
+		cmd.controly = control[ConsolePlayer].controly;
+		cmd.controlstrafe = control[ConsolePlayer].controlstrafe;
+		cmd.buttons = 0;
+		for(unsigned int i = 0;i < NUMBUTTONS;++i)
+		{
+			if(control[ConsolePlayer].buttonstate[i])
+				cmd.buttons |= 1<<i;
+		}
+		self.lastTic = localTic;
+
+		if(InitVars.relay && IsArbiter())
+			RelayTics();
+		else
+			SendTics();
+	}
+
+	// Only stall if someone's command for this tic is missing.
+	const Uint32 stallStart = SDL_GetTicks();
+	unsigned int resend = 20;
+	bool waiting = false;
+	for(;;)
+	{
+		while(NetSim::Recv(Socket, Packet))
+			HandleCommandPackets();
+		RelayTics();
+
+		// If a debug command changes the play state then we should abort
+		if(playstate != ex_stillplaying)
+			return;
 
-		TicCmdPacket &data = ticcmdPackets[client];
+		bool ready = true;
+		for(unsigned int i = 0;i < InitVars.numPlayers;++i)
+		{
+			if(Client[i].lastTic < NetTic)
+			{
+				ready = false;
+				break;
+			}
+		}
+		if(ready)
+			break;
+
+		if(--resend == 0)
+		{
+			SendTics();
+			resend = 20;
+		}
+
+		IN_ProcessEvents();
+
+		if(!waiting)
+			waiting = true;
+		else
+		{
+			// Allow user to enter control panels even if we're waiting for data
+			if(ingame)
+				CheckKeys();
+			Pacer::Idle();
+		}
+	}
+
+	for(unsigned int client = 0;client < InitVars.numPlayers;++client)
+	{
+		const TicCmd &data = Client[client].tics[NetTic%BACKUPTICS];
+		// What was held is relative to the previous queued command rather
+		// than what the local input code last saw.
+		const DWORD held = Client[client].tics[(NetTic+BACKUPTICS-1)%BACKUPTICS].buttons;
 		control[client].controlx = data.controlx;
 		control[client].controly = data.controly;
 		control[client].controlstrafe = data.controlstrafe;
-		memcpy(control[client].buttonstate, data.buttonstate, sizeof(control[client].buttonstate));
-		memcpy(control[client].buttonheld, data.buttonheld, sizeof(control[client].buttonheld));
+		for(unsigned int i = 0;i < NUMBUTTONS;++i)
+		{
+			control[client].buttonstate[i] = (data.buttons>>i)&1;
+			control[client].buttonheld[i] = (held>>i)&1;
+		}
 	}
+	++NetTic;
+
+	NetSim::RecordTic(SDL_GetTicks() - stallStart);
+	if(NetSim::BenchTics && NetTic >= (int32_t)NetSim::BenchTics)
+		Quit();
 
 	if(PlaysimBlocked == gamestate.TimeCount)
 	{
@@ -991,7 +1538,7 @@ bool CheckAck(bool send)
 	if(DidAck == AwaitingAck)
 		return true;
 
-	while(SDLNet_UDP_Recv(Socket, Packet))
+	while(NetSim::Recv(Socket, Packet))
 	{
 		HandleCommandPackets();
 	}
@@ -65,6 +65,8 @@ struct NetInit
 	uint16_t port;
 	byte numPlayers;
 	const char* joinAddress;
+	byte inputDelay; // Tics between a command being made and run
+	bool relay; // Route tic commands through the arbiter
 };
 
 extern NetInit InitVars;
@@ -0,0 +1,230 @@
+/*
+** wl_netsim.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+**
+*/
+
+#include <SDL.h>
+#include <SDL_net.h>
+#include <cstdio>
+
+#include "wl_def.h"
+#include "tarray.h"
+#include "wl_netsim.h"
+
+namespace NetSim {
+
+bool Enabled = false;
+Settings Vars = { 0, 0, 0, 0, 1 };
+unsigned int BenchTics = 0;
+
+// Reordered packets are held back by this much on top of their normal delay
+// which is enough to let the next couple tics worth of packets pass them.
+#define REORDER_DELAY 30
+
+struct QueuedPacket
+{
+	Uint32 deliverAt;
+	int channel;
+	IPaddress address;
+	TArray<BYTE> data;
+};
+
+static TArray<QueuedPacket> queue;
+static DWORD simTic = 0; // Completed game tics
+static DWORD simSequence = 0; // Packets sent so far during this tic
+
+static struct Stats
+{
+	Uint32 startTime;
+	unsigned int tics;
+	unsigned int stallTotal;
+	unsigned int stallMax;
+	unsigned int stalledTics;
+	unsigned int desyncs;
+	unsigned int packetsSent;
+	unsigned int packetsDropped;
+	unsigned int packetsReordered;
+	unsigned int packetsReceived;
+	unsigned int bytesSent;
+	unsigned int bytesReceived;
+} stats;
+
+// Separate from FRandom so that the simulation doesn't affect the game. Each
+// roll is a hash of the packet's position in the game instead of the next
+// value of a generator, so that a different number of retransmissions in
+// another run only changes what happens to the retransmissions themselves.
+static unsigned int Random(unsigned int roll, unsigned int mod)
+{
+	DWORD h = Vars.seed*2654435761u;
+	h ^= simTic + 0x9E3779B9u + (h<<6) + (h>>2);
+	h ^= simSequence + 0x9E3779B9u + (h<<6) + (h>>2);
+	h ^= roll + 0x9E3779B9u + (h<<6) + (h>>2);
+
+	// Final mix so that neighboring inputs give unrelated results
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return mod ? h % mod : 0;
+}
+
+// Sends all queued packets which are due.
+static void Flush(UDPsocket sock)
+{
+	const Uint32 now = SDL_GetTicks();
+	for(unsigned int i = 0;i < queue.Size();)
+	{
+		QueuedPacket &queued = queue[i];
+		if(static_cast<Sint32>(now - queued.deliverAt) < 0)
+		{
+			++i;
+			continue;
+		}
+
+		UDPpacket packet = { queued.channel, &queued.data[0], (int)queued.data.Size(), (int)queued.data.Size(), 0, queued.address };
+		SDLNet_UDP_Send(sock, packet.channel, &packet);
+		queue.Delete(i);
+	}
+}
+
+// Format is latency,jitter,loss,reorder with everything after latency
+// being optional.
+bool ParseSettings(const char* str)
+{
+	Settings settings = Vars;
+	settings.jitter = settings.loss = settings.reorder = 0;
+	if(sscanf(str, "%u,%u,%u,%u", &settings.latency, &settings.jitter, &settings.loss, &settings.reorder) < 1 ||
+		settings.loss > 100 || settings.reorder > 100)
+		return false;
+
+	Vars = settings;
+	Enabled = true;
+	return true;
+}
+
+int Send(UDPsocket sock, int channel, UDPpacket *packet)
+{
+	if(!stats.startTime)
+		stats.startTime = SDL_GetTicks();
+	++stats.packetsSent;
+	stats.bytesSent += packet->len;
+
+	if(!Enabled)
+		return SDLNet_UDP_Send(sock, channel, packet);
+
+	Flush(sock);
+
+	const bool drop = Random(0, 100) < Vars.loss;
+	const unsigned int delay = Vars.latency + Random(1, Vars.jitter+1);
+	const bool reorder = Random(2, 100) < Vars.reorder;
+	++simSequence;
+
+	if(drop)
+	{
+		++stats.packetsDropped;
+		return 1;
+	}
+
+	QueuedPacket &queued = queue[queue.Reserve(1)];
+	queued.deliverAt = SDL_GetTicks() + delay;
+	if(reorder)
+	{
+		queued.deliverAt += REORDER_DELAY;
+		++stats.packetsReordered;
+	}
+	queued.channel = channel;
+	queued.address = packet->address;
+	queued.data.Resize(packet->len);
+	memcpy(&queued.data[0], packet->data, packet->len);
+
+	Flush(sock);
+	return 1;
+}
+
+int Recv(UDPsocket sock, UDPpacket *packet)
+{
+	if(Enabled)
+		Flush(sock);
+
+	const int ret = SDLNet_UDP_Recv(sock, packet);
+	if(ret > 0)
+	{
+		++stats.packetsReceived;
+		stats.bytesReceived += packet->len;
+	}
+	return ret;
+}
+
+void Clear()
+{
+	queue.Clear();
+}
+
+void PrintStats()
+{
+	const double seconds = (SDL_GetTicks() - stats.startTime)/1000.0;
+	Printf("Network statistics:\n");
+	if(Enabled)
+	{
+		Printf("  Simulating %ums latency, %ums jitter, %u%% loss, %u%% reordering\n",
+			Vars.latency, Vars.jitter, Vars.loss, Vars.reorder);
+	}
+	Printf("  %u tics in %.2f seconds (%.2f tics/sec)\n", stats.tics, seconds, seconds > 0 ? stats.tics/seconds : 0.0);
+	Printf("  Stalled %u tics for %ums total, %.2fms per tic, %ums max\n",
+		stats.stalledTics, stats.stallTotal, stats.tics ? (double)stats.stallTotal/stats.tics : 0.0, stats.stallMax);
+	Printf("  Sent %u packets (%u bytes), dropped %u, reordered %u\n",
+		stats.packetsSent, stats.bytesSent, stats.packetsDropped, stats.packetsReordered);
+	Printf("  Received %u packets (%u bytes)\n", stats.packetsReceived, stats.bytesReceived);
+	Printf("  %u desyncs\n", stats.desyncs);
+}
+
+void RecordDesync()
+{
+	++stats.desyncs;
+}
+
+void RecordTic(unsigned int stallms)
+{
+	++simTic;
+	simSequence = 0;
+
+	++stats.tics;
+	if(stallms)
+	{
+		++stats.stalledTics;
+		stats.stallTotal += stallms;
+		stats.stallMax = MAX(stats.stallMax, stallms);
+	}
+}
+
+}
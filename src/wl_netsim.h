@@ -0,0 +1,76 @@
+/*
+** wl_netsim.h
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Simulated network conditions and statistics for testing the net code.
+** When enabled every packet sent goes through a queue which drops, delays
+** and reorders it before handing it to SDL_net, so several instances on one
+** machine behave as if they were connected over a poor link.
+**
+** Packets are delivered once their delay in milliseconds has passed. Whether
+** a packet is dropped or reordered and how much jitter it gets is derived
+** from the seed, the game tic and the packet's place among those sent during
+** that tic, so the same seed always produces the same conditions.
+**
+*/
+
+#ifndef __WL_NETSIM_H__
+#define __WL_NETSIM_H__
+
+#include <SDL_net.h>
+
+namespace NetSim {
+
+struct Settings
+{
+	unsigned int latency;	// One way delay in ms
+	unsigned int jitter;	// Maximum random delay added to latency in ms
+	unsigned int loss;		// Percent of packets dropped
+	unsigned int reorder;	// Percent of packets delayed past the next few
+	unsigned int seed;		// Use a different seed for each instance
+};
+
+extern bool Enabled;
+extern Settings Vars;
+extern unsigned int BenchTics;	// Quit after this many tics, 0 disables
+
+bool	ParseSettings(const char* str);
+
+int		Send(UDPsocket sock, int channel, UDPpacket *packet);
+int		Recv(UDPsocket sock, UDPpacket *packet);
+void	Clear();
+
+void	PrintStats();
+void	RecordDesync();
+void	RecordTic(unsigned int stallms);
+
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+** wl_pacer.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+**
+*/
+
+#include <cmath>
+
+#include "wl_def.h"
+#include "wl_pacer.h"
+#include "zstring.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+namespace Pacer {
+
+unsigned int MaxFPS = 0;
+bool Stats = false;
+
+static uint64_t Frequency = 1000;
+static uint64_t StartTime = 0;
+
+// How long SDL_Delay(1) actually takes, as a moving average and variance.
+static double SleepMean, SleepVariance;
+
+static uint64_t NextFrame = 0;
+
+static const unsigned int HistogramLimits[] = { 2, 4, 8, 12, 16, 20, 33, 50 };
+static const unsigned int NUM_HISTOGRAM = sizeof(HistogramLimits)/sizeof(HistogramLimits[0]) + 1;
+static unsigned int Histogram[NUM_HISTOGRAM];
+static uint64_t LastFrame = 0, StatsStart = 0;
+static double StatsWorst = 0;
+
+static uint64_t ReadCounter()
+{
+#if SDL_VERSION_ATLEAST(2,0,0)
+	return SDL_GetPerformanceCounter();
+#else
+	return SDL_GetTicks();
+#endif
+}
+
+void Init()
+{
+#if SDL_VERSION_ATLEAST(2,0,0)
+	Frequency = SDL_GetPerformanceFrequency();
+#else
+	Frequency = 1000;
+#endif
+	StartTime = ReadCounter();
+
+	// Start by assuming a sleep may oversleep by a few milliseconds
+	SleepMean = Frequency/1000.0;
+	SleepVariance = SleepMean*SleepMean;
+}
+
+uint64_t GetFrequency()
+{
+	return Frequency;
+}
+
+uint64_t GetTime()
+{
+	return ReadCounter() - StartTime;
+}
+
+uint64_t TicTime(int32_t tic)
+{
+	// Round up so that GetTimeCount() returns tic at this time
+	return (static_cast<uint64_t>(tic)*Frequency + TICRATE - 1)/TICRATE;
+}
+
+void SleepUntil(uint64_t deadline)
+{
+	uint64_t now = GetTime();
+
+#ifdef __EMSCRIPTEN__
+	// Spinning would keep the browser from doing anything, so just sleep
+	// which returns to the event loop.
+	if(now < deadline)
+		emscripten_sleep(static_cast<unsigned int>(((deadline - now)*1000 + Frequency - 1)/Frequency));
+#else
+	// Sleep while we're sure to wake up before the deadline, then spin.
+	while(now < deadline && deadline - now > SleepMean + 2*sqrt(SleepVariance))
+	{
+		SDL_Delay(1);
+
+		const uint64_t start = now;
+		now = GetTime();
+
+		const double delta = (now - start) - SleepMean;
+		SleepMean += delta/16;
+		SleepVariance += (delta*delta - SleepVariance)/16;
+	}
+
+	while(now < deadline)
+		now = GetTime();
+#endif
+}
+
+// Call before starting each frame when the frame rate isn't tied to tics.
+void WaitForFrame()
+{
+	const uint64_t now = GetTime();
+	if(MaxFPS == 0)
+	{
+#ifdef __EMSCRIPTEN__
+		// Let the browser present the last frame and handle events.
+		emscripten_sleep(0);
+#endif
+		return;
+	}
+
+	const uint64_t period = Frequency/MaxFPS;
+	if(now >= NextFrame)
+	{
+		// Don't try to catch up with frames that were late
+		NextFrame = now - NextFrame > period ? now + period : NextFrame + period;
+#ifdef __EMSCRIPTEN__
+		emscripten_sleep(0);
+#endif
+		return;
+	}
+
+	SleepUntil(NextFrame);
+	NextFrame += period;
+}
+
+// Gives up the processor while polling for input or packets.
+void Idle()
+{
+#ifdef __EMSCRIPTEN__
+	emscripten_sleep(1);
+#else
+	SDL_Delay(1);
+#endif
+}
+
+// Call when a frame has been presented to collect frame times.
+void FrameDone()
+{
+	if(!Stats)
+		return;
+
+	const uint64_t now = GetTime();
+	if(LastFrame)
+	{
+		const double ms = (now - LastFrame)*1000.0/Frequency;
+		unsigned int bucket = 0;
+		while(bucket < NUM_HISTOGRAM-1 && ms >= HistogramLimits[bucket])
+			++bucket;
+		++Histogram[bucket];
+		if(ms > StatsWorst)
+			StatsWorst = ms;
+	}
+	else
+		StatsStart = now;
+	LastFrame = now;
+
+	if(now - StatsStart < 5*Frequency)
+		return;
+
+	unsigned int frames = 0;
+	for(unsigned int i = 0;i < NUM_HISTOGRAM;++i)
+		frames += Histogram[i];
+
+	FString line;
+	line.Format("%u frames, %.1f fps, worst %.2fms:", frames,
+		frames*(double)Frequency/(now - StatsStart), StatsWorst);
+	for(unsigned int i = 0;i < NUM_HISTOGRAM-1;++i)
+		line.AppendFormat(" <%ums %u", HistogramLimits[i], Histogram[i]);
+	line.AppendFormat(" %ums+ %u\n", HistogramLimits[NUM_HISTOGRAM-2], Histogram[NUM_HISTOGRAM-1]);
+	Printf("%s", line.GetChars());
+
+	memset(Histogram, 0, sizeof(Histogram));
+	StatsWorst = 0;
+	StatsStart = now;
+}
+
+}
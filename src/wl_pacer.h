@@ -0,0 +1,60 @@
+/*
+** wl_pacer.h
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** High resolution timing for the play loop. Waits sleep until shortly
+** before the deadline and spin for the rest, using how late sleeps have
+** actually woken up to decide when to switch.
+**
+*/
+
+#ifndef __WL_PACER_H__
+#define __WL_PACER_H__
+
+#include "wl_def.h"
+
+namespace Pacer {
+
+extern unsigned int MaxFPS;	// Frame rate cap for uncapped rendering, 0 for none
+extern bool Stats;	// Print frame time histograms
+
+uint64_t	GetFrequency();
+uint64_t	GetTime();	// In GetFrequency() units since Init
+uint64_t	TicTime(int32_t tic);	// When the given tic starts
+
+void		FrameDone();
+void		Idle();
+void		Init();
+void		SleepUntil(uint64_t deadline);
+void		WaitForFrame();
+
+}
+
+#endif
@@ -8,9 +8,6 @@
 #include "wl_main.h"
 #include "wl_draw.h"
 
-extern fixed viewz;
-extern int viewshift;
-
 // Fill in a column of pixels. Could be potentially have a POT version but not
 // sure if it's worthwhile.
 static void DrawParallaxPlaneLoop(byte *vbuf, unsigned vbufPitch,
@@ -29,10 +26,14 @@ static void DrawParallaxPlaneLoop(byte *vbuf, unsigned vbufPitch,
 
 // Draws one of the two sky planes: above or below wallheight
 template<bool ceiling>
-static void DrawParallaxPlane(byte *vbuf, unsigned vbufPitch,
+static void DrawParallaxPlane(const RenderContext &ctx,
 	FTexture *skysource, int yshift,
 	int midangle, fixed planeheight, int horizonheight, int skyscaledheight)
 {
+	byte* const vbuf = ctx.buf;
+	const unsigned vbufPitch = ctx.pitch;
+	const int viewheight = ctx.viewheight;
+
 	const fixed heightFactor = abs(planeheight)>>8;
 
 	const int w = skysource->GetWidth();
@@ -43,9 +44,9 @@ static void DrawParallaxPlane(byte *vbuf, unsigned vbufPitch,
 
 	int curtex = -1;
 	const byte *skytex = NULL;
-	for(int x = 0; x < viewwidth; x++)
+	for(int x = 0; x < ctx.viewwidth; x++)
 	{
-		int curang = pixelangle[x] + midangle;
+		int curang = ctx.pixelangle[x] + midangle;
 		if(curang < 0) curang += FINEANGLES;
 		else if(curang >= FINEANGLES) curang -= FINEANGLES;
 		const int xtex = (FINEANGLES - curang - 1) * w / cycle;
@@ -58,7 +59,7 @@ static void DrawParallaxPlane(byte *vbuf, unsigned vbufPitch,
 
 		if(ceiling)
 		{
-			int yend = horizonheight - ((wallheight[x]*heightFactor)>>FRACBITS);
+			int yend = horizonheight - ((ctx.wallheight[x]*heightFactor)>>FRACBITS);
 			if(yend <= 0)
 				continue;
 			if(yend >= viewheight)
@@ -68,7 +69,7 @@ static void DrawParallaxPlane(byte *vbuf, unsigned vbufPitch,
 		}
 		else
 		{
-			int ystart = horizonheight + ((wallheight[x]*heightFactor)>>FRACBITS);
+			int ystart = horizonheight + ((ctx.wallheight[x]*heightFactor)>>FRACBITS);
 			if(ystart < 0)
 				ystart = 0;
 
@@ -77,7 +78,7 @@ static void DrawParallaxPlane(byte *vbuf, unsigned vbufPitch,
 	}
 }
 
-void DrawParallax(byte *vbuf, unsigned vbufPitch)
+void DrawParallax(const RenderContext &ctx)
 {
 	FTextureID skyid = levelInfo->Sky;
 	double scrollSpeed = levelInfo->SkyScrollSpeed;
@@ -95,6 +96,7 @@ void DrawParallax(byte *vbuf, unsigned vbufPitch)
 		return;
 
 	FTexture * const skysource = TexMan(skyid);
+	TexMan.MarkUsed(skysource);
 	const int skyheight = skysource->GetScaledHeight();
 
 	// Texel of horizon line
@@ -127,20 +129,20 @@ void DrawParallax(byte *vbuf, unsigned vbufPitch)
 
 	// For a speed of 1 cycle roughly every 30 seconds (roughly in line with ZDoom)
 	const angle_t scroll = xs_ToInt(scrollSpeed*gamestate.TimeCount*(1<<27)/TICRATE);
-	const int midangle = (players[ConsolePlayer].camera->angle + scroll)>>ANGLETOFINESHIFT;
+	const int midangle = (ctx.camera->angle + scroll)>>ANGLETOFINESHIFT;
 	// Position of world horizon line
-	const int horizonheight = (viewheight >> 1) - viewshift;
+	const int horizonheight = (ctx.viewheight >> 1) - ctx.viewshift;
 	// We want to map the sky onto the upper and lower 100 pixels of the 320x200
 	// canvas.  So we can use the psprite scale variables to determine the size.
 	// Note: Round these up since the 1.2 scaling factor has round off
-	const int skyscaledheight = ((MAX(100, skyheight)*pspriteyscale)+(FRACUNIT-1))>>FRACBITS;
+	const int skyscaledheight = ((MAX(100, skyheight)*ctx.pspriteyscale)+(FRACUNIT-1))>>FRACBITS;
 	const int skyscaledhorizon = (skyhorizon*skyscaledheight+skyheight-1)/skyheight;
 
 	// Determines the offset to y when determining texel
-	int yshift = (skyscaledhorizon) - (viewheight>>1) + viewshift;
+	int yshift = (skyscaledhorizon) - (ctx.viewheight>>1) + ctx.viewshift;
 	if(yshift < 0)
 		yshift = (skyscaledheight)-((-yshift)%(skyscaledheight));
 
-	DrawParallaxPlane<true>(vbuf, vbufPitch, skysource, yshift, midangle, viewz+(map->GetPlane(0).depth<<FRACBITS), horizonheight, skyscaledheight);
-	DrawParallaxPlane<false>(vbuf, vbufPitch, skysource, yshift, midangle, viewz, horizonheight, skyscaledheight);
+	DrawParallaxPlane<true>(ctx, skysource, yshift, midangle, ctx.viewz+(map->GetPlane(0).depth<<FRACBITS), horizonheight, skyscaledheight);
+	DrawParallaxPlane<false>(ctx, skysource, yshift, midangle, ctx.viewz, horizonheight, skyscaledheight);
 }
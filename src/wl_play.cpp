@@ -23,7 +23,9 @@
 #include "wl_game.h"
 #include "wl_inter.h"
 #include "wl_net.h"
+#include "wl_pacer.h"
 #include "wl_play.h"
+#include "wl_rewind.h"
 #include "g_mapinfo.h"
 #include "a_inventory.h"
 #include "am_map.h"
@@ -55,6 +57,8 @@ extern bool ShadowingEnabled;
 #endif
 
 bool noclip, ammocheat, mouselook = false;
+bool MouseLatencyStats = false;
+angle_t LateMouseYaw = 0;
 int godmode, singlestep;
 bool notargetmode = false;
 unsigned int extravbls = 0; // to remove flicker (gray stuff at the bottom)
@@ -65,6 +69,7 @@ unsigned short Paused;
 //
 bool noadaptive = false;
 unsigned tics;
+fixed TicFrac = FRACUNIT;
 
 //
 // control info
@@ -185,7 +190,7 @@ static int32_t lasttimecount;
 
 int32_t GetTimeCount()
 {
-	return MS2TICS(SDL_GetTicks());
+	return static_cast<int32_t>(Pacer::GetTime()*TICRATE/Pacer::GetFrequency());
 }
 
 /*
@@ -202,20 +207,15 @@ void CalcTics()
 // calculate tics since last refresh for adaptive timing
 //
 
-	// Have we arrived too soon?
-	while(lasttimecount == GetTimeCount()+1)
-		SDL_Delay(1);
-
 	// Detect rollover, particularly if the game were paused for a LONG time
 	if(lasttimecount > GetTimeCount())
 		ResetTimeCount();
 
-	uint32_t curtime = SDL_GetTicks();
-	tics = MS2TICS(curtime) - lasttimecount;
+	tics = GetTimeCount() - lasttimecount;
 	if(!tics)
 	{
 		// wait until end of current tic
-		SDL_Delay(TICS2MS(lasttimecount + 1) - curtime);
+		Pacer::SleepUntil(Pacer::TicTime(lasttimecount + 1));
 		tics = 1;
 	}
 	else if(noadaptive || Net::IsBlocked())
@@ -227,6 +227,57 @@ void CalcTics()
 		tics = MAXTICS;
 }
 
+/*
+=====================
+=
+= CalcUncappedTics
+=
+= Like CalcTics, but doesn't wait for a tic to pass. TicFrac is set to how
+= far the current time is between the last two tics so the frame can be drawn
+= in between them.
+=
+=====================
+*/
+
+static void CalcUncappedTics()
+{
+	Pacer::WaitForFrame();
+
+	const int32_t curtics = GetTimeCount();
+
+	// Detect rollover, particularly if the game were paused for a LONG time
+	if(lasttimecount > curtics+1)
+		ResetTimeCount();
+
+	tics = lasttimecount < curtics ? curtics - lasttimecount : 0;
+	if(tics && noadaptive)
+		tics = 1;
+
+	lasttimecount += tics;
+
+	if (tics>MAXTICS)
+		tics = MAXTICS;
+
+	if(Paused || lasttimecount < curtics)
+		TicFrac = FRACUNIT;
+	else
+	{
+		const uint64_t start = Pacer::TicTime(lasttimecount);
+		const uint64_t curtime = Pacer::GetTime();
+		if(curtime <= start)
+			TicFrac = 0;
+		else
+			TicFrac = static_cast<fixed>(MIN<uint64_t>((curtime - start)*TICRATE*FRACUNIT/Pacer::GetFrequency(), FRACUNIT));
+	}
+}
+
+// Demos and net games stay capped since the tic and frame rates must match.
+static bool UncappedRendering()
+{
+	return vid_uncapped && !demoplayback && !demorecord &&
+		Net::InitVars.mode == Net::MODE_SinglePlayer;
+}
+
 void ResetTimeCount()
 {
 	lasttimecount = GetTimeCount();
@@ -235,7 +286,7 @@ void ResetTimeCount()
 void Delay(int wolfticks)
 {
 	if(wolfticks>0)
-		SDL_Delay(TICS2MS(wolfticks));
+		Pacer::SleepUntil(Pacer::GetTime() + Pacer::TicTime(wolfticks));
 }
 
 /*
@@ -426,6 +477,102 @@ void PollKeyboardMove (void)
 }
 
 
+/*
+===================
+=
+= Late mouse latch
+=
+= The mouse is read again right before the view is rendered and the view
+= angle is turned by whatever motion arrived after the tic was polled. That
+= motion is kept pending and handed to the next tic, so the simulation (and
+= with it demos and net games) only ever sees whole tic commands and ends up
+= at the angle that was already displayed.
+=
+===================
+*/
+
+static int pendingmousex, pendingmousey;	// Read but not yet given to a tic
+static double mousesampletime;	// When the newest motion shown was read
+
+static double MouseLatencyTime()
+{
+	return (double)Pacer::GetTime()/Pacer::GetFrequency();
+}
+
+static void ReadMouseMotion()
+{
+	int x, y;
+	SDL_GetRelativeMouseState(&x, &y);
+	if(x || y)
+	{
+		pendingmousex += x;
+		pendingmousey += y;
+		if(MouseLatencyStats)
+			mousesampletime = MouseLatencyTime();
+	}
+}
+
+static void ClearMouseMotion()
+{
+	pendingmousex = pendingmousey = 0;
+	mousesampletime = 0;
+}
+
+// Returns how much the view should be turned for motion not yet ticked.
+// In net games our input is queued behind the input delay, so turning the
+// view ahead of it would snap back once the tic actually runs.
+static angle_t LatchMouseYaw()
+{
+	player_t &player = players[ConsolePlayer];
+	if(!latemouselatch || Net::InitVars.mode != Net::MODE_SinglePlayer || demoplayback || Paused || playstate != ex_stillplaying ||
+		!mouseenabled || !IN_IsInputGrabbed() || player.camera != player.mo ||
+		player.state != player_t::PST_LIVE || control[ConsolePlayer].buttonstate[bt_strafe])
+		return 0;
+
+	SDL_PumpEvents();
+	ReadMouseMotion();
+
+	// Same as PollMouseMove and ControlMovement
+	int controlx = pendingmousex * 20 / (21 - mousexadjustment);
+	if(player.ReadyWeapon && player.ReadyWeapon->fovscale > 0)
+		controlx = xs_ToInt(controlx*player.ReadyWeapon->fovscale);
+	angle_t yaw = 0 - controlx*(ANGLE_1/ANGLESCALE);
+
+	// Turning is shown up to date, so take out any interpolation of the angle
+	if(TicFrac < FRACUNIT)
+		yaw += player.mo->tickangle - player.mo->angle;
+	return yaw;
+}
+
+// Prints how old the mouse motion shown on screen was when presented.
+static void UpdateMouseLatencyStats()
+{
+	static double total = 0, worst = 0, lastprint = 0;
+	static unsigned int frames = 0;
+
+	const double now = MouseLatencyTime();
+	if(mousesampletime > 0)
+	{
+		const double latency = now - mousesampletime;
+		total += latency;
+		worst = MAX(worst, latency);
+		++frames;
+		mousesampletime = 0;
+	}
+
+	if(now - lastprint >= 2.0)
+	{
+		if(frames)
+		{
+			Printf("Mouse to present: %.2fms average, %.2fms worst over %u frames (late latch %s)\n",
+				total*1000/frames, worst*1000, frames, latemouselatch ? "on" : "off");
+		}
+		total = worst = 0;
+		frames = 0;
+		lastprint = now;
+	}
+}
+
 /*
 ===================
 =
@@ -436,7 +583,10 @@ void PollKeyboardMove (void)
 
 void PollMouseMove (void)
 {
-	SDL_GetRelativeMouseState(&control[ConsolePlayer].controlpanx, &control[ConsolePlayer].controlpany);
+	ReadMouseMotion();
+	control[ConsolePlayer].controlpanx = pendingmousex;
+	control[ConsolePlayer].controlpany = pendingmousey;
+	pendingmousex = pendingmousey = 0;
 
 	control[ConsolePlayer].controlx += control[ConsolePlayer].controlpanx * 20 / (21 - mousexadjustment);
 	if(mouselook)
@@ -643,20 +793,21 @@ void ProcessEvents()
 //
 // get timing info for last frame
 //
+	TicFrac = FRACUNIT;
 	if (demoplayback || demorecord)   // demo recording and playback needs to be constant
 	{
 		// wait up to DEMOTICS Wolf tics
-		uint32_t curtime = SDL_GetTicks();
+		const int32_t curtics = GetTimeCount();
 		lasttimecount += DEMOTICS;
-		int32_t timediff = TICS2MS(lasttimecount) - curtime;
-		if(timediff > 0)
-			SDL_Delay(timediff);
-
-		if(timediff < -2 * DEMOTICS)       // more than 2-times DEMOTICS behind?
-			lasttimecount = MS2TICS(curtime);    // yes, set to current timecount
+		if(lasttimecount > curtics)
+			Pacer::SleepUntil(Pacer::TicTime(lasttimecount));
+		else if(curtics - lasttimecount > 2 * DEMOTICS)       // more than 2-times DEMOTICS behind?
+			lasttimecount = curtics;    // yes, set to current timecount
 
 		tics = DEMOTICS;
 	}
+	else if (UncappedRendering())
+		CalcUncappedTics ();
 	else
 		CalcTics ();
 }
@@ -993,10 +1144,20 @@ void PlayFrame()
 {
 	UpdatePaletteShifts ();
 
+	// Draw the world between the last two tics when rendering is uncapped
+	const bool interpolate = TicFrac < FRACUNIT;
+	if(interpolate)
+		thinkerList.BeginInterpolation(TicFrac);
+
+	LateMouseYaw = LatchMouseYaw();
 	ThreeDRefresh ();
+	LateMouseYaw = 0;
 
 	if(automap && !gamestate.victoryflag)
 		BasicOverhead();
+
+	if(interpolate)
+		thinkerList.EndInterpolation();
 	if(Paused & 1)
 		VWB_DrawGraphic(TexMan("PAUSED"), (20 - 4)*8, 80 - 2*8);
 
@@ -1008,7 +1169,8 @@ void PlayFrame()
 
 	if (!loadedgame)
 	{
-		StatusBar->Tick();
+		if (tics)
+			StatusBar->Tick();
 		if ((gamestate.TimeCount & 1) || !(tics & 1))
 			StatusBar->DrawStatusBar();
 	}
@@ -1020,6 +1182,10 @@ void PlayFrame()
 	}
 
 	VH_UpdateScreen();
+	Pacer::FrameDone();
+
+	if(MouseLatencyStats)
+		UpdateMouseLatencyStats();
 }
 
 /*
@@ -1057,6 +1223,7 @@ void PlayLoop (void)
 
 	if (MousePresent && IN_IsInputGrabbed())
 		IN_CenterMouse();         // Clear accumulated mouse movement
+	ClearMouseMotion();
 
 	if (demoplayback)
 		IN_StartAck (ACK_Local);
@@ -1085,6 +1252,9 @@ void PlayLoop (void)
 			{
 				++gamestate.TimeCount;
 
+				if(UncappedRendering())
+					thinkerList.StorePrevStates();
+
 				CheckSpawnPlayer();
 
 				// In single player if the player dies only tick the pawn
@@ -1094,6 +1264,8 @@ void PlayLoop (void)
 					thinkerList.Tick(ThinkerList::PLAYER);
 
 				AActor::FinishSpawningActors();
+
+				Rewind::Tick();
 			}
 		}
 
@@ -1105,6 +1277,7 @@ void PlayLoop (void)
 		funnyticount += tics;
 
 		TexMan.UpdateAnimations(lasttimecount*14);
+		TexMan.TrimCache();
 		GC::CheckGC();
 
 		UpdateSoundLoc ();      // JAB
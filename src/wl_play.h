@@ -18,6 +18,7 @@
 
 extern  bool noadaptive;
 extern  unsigned        tics;
+extern  fixed           TicFrac;	// How far between the last two tics to draw
 extern  int             viewsize;
 extern unsigned short Paused;
 
@@ -64,6 +65,8 @@ void ResetTimeCount();
 extern  int32_t     funnyticount;           // FOR FUNNY BJ FACE
 
 extern  bool        noclip,ammocheat,mouselook;
+extern  bool        MouseLatencyStats;
+extern  angle_t     LateMouseYaw;	// View turn for mouse motion not yet ticked
 extern  int         singlestep;
 extern  unsigned int extravbls;
 
@@ -0,0 +1,244 @@
+/*
+** wl_rewind.cpp
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 ECWolf Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+**
+*/
+
+#include <zlib.h>
+
+#include "wl_def.h"
+#include "actor.h"
+#include "farchive.h"
+#include "gamemap.h"
+#include "m_random.h"
+#include "thinker.h"
+#include "version.h"
+#include "wl_game.h"
+#include "wl_loadsave.h"
+#include "wl_net.h"
+#include "wl_play.h"
+#include "wl_rewind.h"
+
+namespace Rewind {
+
+// Off by default since every snapshot serializes, diffs and compresses the
+// whole level on the game thread. Set RewindInterval in the config to use it.
+unsigned int Interval = 0;
+unsigned int MemoryLimit = 4096;
+
+struct Snapshot
+{
+	int32_t			time;
+	unsigned int	size;
+	// Compressed XOR of this snapshot against the next newer one, both
+	// padded with zeros to the larger of the two sizes. Empty for the newest.
+	TArray<BYTE>	delta;
+};
+
+static TArray<TUniquePtr<Snapshot> > snapshots;
+// The newest snapshot is in buffers[current], the other buffer is reused as
+// scratch space so that snapshots of similar size don't need to reallocate.
+static TArray<BYTE> buffers[2], expand;
+static unsigned int current = 0;
+static unsigned int deltaBytes = 0;
+static char snapshotMap[9] = {0};
+
+static void WriteState(TArray<BYTE> &buffer)
+{
+	GameSave::SaveVersion = GetSaveVersion();
+	GameSave::SaveProdVersion = SAVEPRODVER;
+
+	FMemFile file(buffer, FFile::EWriting);
+	FArchive arc(file);
+	GameSave::Serialize(arc);
+	FRandom::StaticSerializeRNGState(arc);
+}
+
+static void ReadState(TArray<BYTE> &buffer)
+{
+	GameSave::SaveVersion = GetSaveVersion();
+	GameSave::SaveProdVersion = SAVEPRODVER;
+
+	// Same as a level reload except the map structure is kept, all mutable
+	// map state is overwritten by the archive.
+	AActor::FinishSpawningActors();
+	thinkerList.DestroyAll(ThinkerList::TRAVEL);
+
+	FMemFile file(buffer, FFile::EReading);
+	FArchive arc(file);
+	GameSave::Serialize(arc);
+	FRandom::StaticSerializeRNGState(arc);
+}
+
+// XOR src into dest, growing dest with zeros as needed.
+static void XorInto(TArray<BYTE> &dest, const BYTE *src, unsigned int len)
+{
+	if(dest.Size() < len)
+	{
+		unsigned int start = dest.Reserve(len - dest.Size());
+		memset(&dest[start], 0, dest.Size() - start);
+	}
+
+	BYTE *out = &dest[0];
+	unsigned int i = 0;
+	for(;i + sizeof(DWORD) <= len;i += sizeof(DWORD))
+	{
+		DWORD a, b;
+		memcpy(&a, out+i, sizeof(DWORD));
+		memcpy(&b, src+i, sizeof(DWORD));
+		a ^= b;
+		memcpy(out+i, &a, sizeof(DWORD));
+	}
+	for(;i < len;++i)
+		out[i] ^= src[i];
+}
+
+static void EncodeDelta(Snapshot &older, const TArray<BYTE> &olderData, const TArray<BYTE> &newerData)
+{
+	expand.Clear();
+	if(olderData.Size())
+		XorInto(expand, &olderData[0], olderData.Size());
+	if(newerData.Size())
+		XorInto(expand, &newerData[0], newerData.Size());
+
+	uLong outlen = compressBound(expand.Size());
+	older.delta.Resize(outlen);
+	if(compress2(&older.delta[0], &outlen, &expand[0], expand.Size(), Z_BEST_SPEED) != Z_OK)
+		I_Error("Could not compress rewind snapshot");
+	older.delta.Resize(outlen);
+	older.delta.ShrinkToFit();
+	deltaBytes += older.delta.Size();
+}
+
+// Turns data from the newer snapshot into the state of older.
+static void DecodeDelta(const Snapshot &older, TArray<BYTE> &data)
+{
+	uLong len = MAX(older.size, data.Size());
+	expand.Resize(len);
+	if(uncompress(&expand[0], &len, &older.delta[0], older.delta.Size()) != Z_OK || len != expand.Size())
+		I_Error("Could not decompress rewind snapshot");
+
+	XorInto(data, &expand[0], len);
+	data.Resize(older.size);
+}
+
+static void DropOldest()
+{
+	deltaBytes -= snapshots[0]->delta.Size();
+	snapshots.Delete(0);
+}
+
+void Clear()
+{
+	snapshots.Clear();
+	for(unsigned int i = 0;i < 2;++i)
+	{
+		buffers[i].Clear();
+		buffers[i].ShrinkToFit();
+	}
+	expand.Clear();
+	expand.ShrinkToFit();
+	deltaBytes = 0;
+	snapshotMap[0] = 0;
+}
+
+unsigned int GetMemoryUsage()
+{
+	return deltaBytes + buffers[0].Max() + buffers[1].Max() + expand.Max();
+}
+
+unsigned int GetNumSnapshots()
+{
+	return snapshots.Size();
+}
+
+void Take()
+{
+	// Snapshots are only valid for the level they were taken on.
+	if(strncmp(snapshotMap, gamestate.mapname, 8) != 0)
+	{
+		Clear();
+		strncpy(snapshotMap, gamestate.mapname, 8);
+	}
+
+	TArray<BYTE> &newest = buffers[current^1];
+	WriteState(newest);
+
+	if(snapshots.Size() > 0)
+		EncodeDelta(*snapshots[snapshots.Size()-1], buffers[current], newest);
+	current ^= 1;
+
+	Snapshot *snap = new Snapshot;
+	snap->time = gamestate.TimeCount;
+	snap->size = newest.Size();
+	snapshots.Push(snap);
+
+	while(snapshots.Size() > 1 && GetMemoryUsage() > MemoryLimit*1024)
+		DropOldest();
+}
+
+bool Restore(unsigned int tics)
+{
+	if(snapshots.Size() == 0 || strncmp(snapshotMap, gamestate.mapname, 8) != 0)
+		return false;
+
+	const int32_t target = gamestate.TimeCount - (int32_t)tics;
+
+	// Find the newest snapshot at or before the target time, or the oldest
+	// we have if we can't go back that far.
+	unsigned int index = snapshots.Size()-1;
+	while(index > 0 && snapshots[index]->time > target)
+		--index;
+
+	for(unsigned int i = snapshots.Size()-1;i-- > index;)
+	{
+		DecodeDelta(*snapshots[i], buffers[current]);
+		deltaBytes -= snapshots[i]->delta.Size();
+		snapshots[i]->delta.Clear();
+		snapshots[i]->delta.ShrinkToFit();
+	}
+	// History after the restored point is no longer reachable.
+	snapshots.Resize(index+1);
+
+	ReadState(buffers[current]);
+	return true;
+}
+
+void Tick()
+{
+	if(Interval == 0 || Net::InitVars.mode != Net::MODE_SinglePlayer || demoplayback || demorecord)
+		return;
+
+	if(gamestate.TimeCount % Interval == 0)
+		Take();
+}
+
+}
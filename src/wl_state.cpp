@@ -121,7 +121,7 @@ bool TrySpot(AActor *ob, MapSpot spot)
 static inline short CheckSide(AActor *ob, unsigned int x, unsigned int y, MapTrigger::Side dir, bool canuse)
 {
 	MapSpot spot = map->GetSpot(x, y, 0);
-	if(spot->tile)
+	if(map->GetClip(x, y, 0) & GameMap::CLIP_Tile)
 	{
 		if(canuse)
 		{
@@ -141,7 +141,8 @@ static inline short CheckSide(AActor *ob, unsigned int x, unsigned int y, MapTri
 				return 1;
 			}
 		}
-		if(spot->slideAmount[dir] != 0xffff)
+		// Triggers may have changed the spot so check again.
+		if(!(map->GetClip(x, y, 0) & (GameMap::CLIP_SideOpen<<dir)))
 			return 0;
 	}
 
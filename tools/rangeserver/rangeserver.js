@@ -0,0 +1,73 @@
+#!/usr/bin/env node
+// Minimal static file server with HTTP range support for testing streamed
+// archives (Module.lazyFiles) in the web build.
+//
+//   node tools/rangeserver/rangeserver.js <directory> [port]
+
+"use strict";
+
+const fs = require("fs");
+const http = require("http");
+const path = require("path");
+
+const root = path.resolve(process.argv[2] || ".");
+const port = parseInt(process.argv[3] || "8080", 10);
+
+const types = {
+	".html": "text/html",
+	".js": "text/javascript",
+	".mjs": "text/javascript",
+	".wasm": "application/wasm",
+	".data": "application/octet-stream"
+};
+
+http.createServer((req, res) => {
+	const file = path.join(root, decodeURIComponent(new URL(req.url, "http://localhost").pathname));
+	// Compare against the separator so that a sibling such as /srv/data2
+	// doesn't pass for /srv/data
+	if (file !== root && !file.startsWith(root + path.sep)) {
+		res.writeHead(403).end();
+		return;
+	}
+
+	fs.stat(file, (err, stat) => {
+		if (err || !stat.isFile()) {
+			res.writeHead(404).end();
+			return;
+		}
+
+		const headers = {
+			"Accept-Ranges": "bytes",
+			"Content-Type": types[path.extname(file)] || "application/octet-stream",
+			// Lets lazyFiles.js notice when a file it cached has changed
+			"ETag": `"${stat.size}-${Math.floor(stat.mtimeMs)}"`,
+			// Allows the SIMD/threads variant to be tested as well
+			"Cross-Origin-Opener-Policy": "same-origin",
+			"Cross-Origin-Embedder-Policy": "require-corp"
+		};
+
+		let start = 0, end = stat.size - 1, status = 200;
+		const range = /^bytes=(\d*)-(\d*)$/.exec(req.headers.range || "");
+		if (range && (range[1] || range[2])) {
+			if (range[1]) {
+				start = parseInt(range[1], 10);
+				if (range[2]) end = Math.min(parseInt(range[2], 10), end);
+			} else {
+				start = Math.max(stat.size - parseInt(range[2], 10), 0);
+			}
+
+			if (start > end) {
+				res.writeHead(416, { "Content-Range": `bytes */${stat.size}` }).end();
+				return;
+			}
+			status = 206;
+			headers["Content-Range"] = `bytes ${start}-${end}/${stat.size}`;
+		}
+		headers["Content-Length"] = end - start + 1;
+
+		console.log(`${req.method} ${req.url} ${status} ${headers["Content-Length"]}`);
+		res.writeHead(status, headers);
+		if (req.method === "HEAD") res.end();
+		else fs.createReadStream(file, { start, end }).pipe(res);
+	});
+}).listen(port, () => console.log(`Serving ${root} on http://localhost:${port}/`));